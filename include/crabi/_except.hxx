@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdlib>
+
+// Error reporting for the checked operations of the library (such as `option::unwrap` and `array::at`).
+// When exceptions are disabled (`-fno-exceptions`), these abort instead of throwing, as a Rust panic does with `panic=abort`,
+// and the exception object (including any formatted message) is never constructed. The non-throwing alternatives (`result`, `option`) are unaffected.
+
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define _CRABI_HAS_EXCEPTIONS 1
+#define _CRABI_THROW(...) throw __VA_ARGS__
+#else
+#define _CRABI_THROW(...) ::std::abort()
+#endif
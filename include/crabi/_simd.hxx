@@ -0,0 +1,573 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <bit>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define _CRABI_SIMD_SSE2 1
+#endif
+
+#if defined(__SSSE3__) || defined(__AVX2__)
+#define _CRABI_SIMD_SSSE3 1
+#endif
+
+#if defined(__AVX2__)
+#define _CRABI_SIMD_AVX2 1
+#endif
+
+// With GCC and Clang, the SSSE3 and AVX2 UTF-8 validators are also compiled when the target does not enable those instruction sets, and selected at runtime
+#if defined(_CRABI_SIMD_SSE2) && !defined(_CRABI_SIMD_AVX2) && (defined(__GNUC__) || defined(__clang__))
+#define _CRABI_SIMD_DISPATCH 1
+#define _CRABI_SIMD_PRAGMA(x) _Pragma(#x)
+#define _CRABI_SIMD_ALWAYS_INLINE [[gnu::always_inline]]
+#if defined(__clang__)
+#define _CRABI_SIMD_TARGET_PUSH(isa) _CRABI_SIMD_PRAGMA(clang attribute push(__attribute__((target(isa))), apply_to = function))
+#define _CRABI_SIMD_TARGET_POP() _CRABI_SIMD_PRAGMA(clang attribute pop)
+#else
+#define _CRABI_SIMD_TARGET_PUSH(isa) _CRABI_SIMD_PRAGMA(GCC push_options) _CRABI_SIMD_PRAGMA(GCC target(isa))
+#define _CRABI_SIMD_TARGET_POP() _CRABI_SIMD_PRAGMA(GCC pop_options)
+#endif
+#else
+#define _CRABI_SIMD_ALWAYS_INLINE
+#endif
+
+// Vectorized search kernels used by `slice` and `str`.
+// The instruction set is selected at compile time (SSE2 is baseline on x86_64, SSSE3 and AVX2 with `-mssse3`/`-mavx2`/`-march=...`), with a scalar fallback elsewhere.
+// UTF-8 validation, which benefits the most from SSSE3 and AVX2, instead selects its kernel at runtime where the compiler allows it (see `_CRABI_SIMD_DISPATCH`).
+// Each kernel must only be called outside of constant evaluation.
+
+namespace crabi::_detail{
+    /// Types for which equality is bitwise equality of a single 1, 2, 4, or 8 byte lane
+    template<typename T> concept _simd_scalar = (std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>)
+        && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+    template<typename T> using _simd_lane_t = std::conditional_t<sizeof(T) == 1, std::uint8_t,
+        std::conditional_t<sizeof(T) == 2, std::uint16_t,
+        std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>>;
+
+#ifdef _CRABI_SIMD_SSE2
+    template<typename Lane> inline __m128i _simd_splat128(Lane val) noexcept{
+        if constexpr(sizeof(Lane) == 1)
+            return _mm_set1_epi8(static_cast<char>(val));
+        else if constexpr(sizeof(Lane) == 2)
+            return _mm_set1_epi16(static_cast<short>(val));
+        else if constexpr(sizeof(Lane) == 4)
+            return _mm_set1_epi32(static_cast<int>(val));
+        else
+            return _mm_set1_epi64x(static_cast<long long>(val));
+    }
+
+    /// Compares each lane of `a` and `b`, setting every byte of the lanes that are equal
+    template<typename Lane> inline __m128i _simd_cmpeq128(__m128i a, __m128i b) noexcept{
+        if constexpr(sizeof(Lane) == 1)
+            return _mm_cmpeq_epi8(a, b);
+        else if constexpr(sizeof(Lane) == 2)
+            return _mm_cmpeq_epi16(a, b);
+        else if constexpr(sizeof(Lane) == 4)
+            return _mm_cmpeq_epi32(a, b);
+        else{
+            // SSE2 has no 64-bit compare: a 64-bit lane is equal if both of its 32-bit halves are
+            __m128i eq = _mm_cmpeq_epi32(a, b);
+            return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+    }
+#endif
+
+#ifdef _CRABI_SIMD_AVX2
+    template<typename Lane> inline __m256i _simd_splat256(Lane val) noexcept{
+        if constexpr(sizeof(Lane) == 1)
+            return _mm256_set1_epi8(static_cast<char>(val));
+        else if constexpr(sizeof(Lane) == 2)
+            return _mm256_set1_epi16(static_cast<short>(val));
+        else if constexpr(sizeof(Lane) == 4)
+            return _mm256_set1_epi32(static_cast<int>(val));
+        else
+            return _mm256_set1_epi64x(static_cast<long long>(val));
+    }
+
+    template<typename Lane> inline __m256i _simd_cmpeq256(__m256i a, __m256i b) noexcept{
+        if constexpr(sizeof(Lane) == 1)
+            return _mm256_cmpeq_epi8(a, b);
+        else if constexpr(sizeof(Lane) == 2)
+            return _mm256_cmpeq_epi16(a, b);
+        else if constexpr(sizeof(Lane) == 4)
+            return _mm256_cmpeq_epi32(a, b);
+        else
+            return _mm256_cmpeq_epi64(a, b);
+    }
+#endif
+
+    /// Returns the index of the first element of `[p, p+n)` equal to `val`, or `n` if there is none
+    template<_simd_scalar T> inline std::size_t _simd_find(const T* p, std::size_t n, T val) noexcept{
+        using lane = _simd_lane_t<T>;
+        if constexpr(sizeof(T) == 1){
+            // libc's memchr selects the widest available vector unit at runtime, which a header compiled for the baseline target cannot
+            const void* found = std::memchr(p, std::bit_cast<unsigned char>(val), n);
+            return found ? static_cast<std::size_t>(static_cast<const T*>(found) - p) : n;
+        }
+        [[maybe_unused]] const unsigned char* bytes = reinterpret_cast<const unsigned char*>(p);
+        [[maybe_unused]] const std::size_t len = n * sizeof(T);
+        const lane needle = std::bit_cast<lane>(val);
+        std::size_t i = 0;
+#if defined(_CRABI_SIMD_AVX2)
+        const __m256i splat = _simd_splat256(needle);
+        if(len >= 128){
+            // Check the first (unaligned) vector, then continue from the next 32-byte boundary so that no load in the main loop splits a cache line.
+            // This stays on a lane boundary, since `bytes` is aligned to `sizeof(T)`
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_simd_cmpeq256<lane>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes)), splat)));
+            if(mask)
+                return std::countr_zero(mask) / sizeof(T);
+            i = 32 - (reinterpret_cast<std::uintptr_t>(bytes) & 31);
+        }
+        // Four vectors per iteration, so that the loop is bound by load throughput rather than by the branch
+        for(; i + 128 <= len; i += 128){
+            __m256i e0 = _simd_cmpeq256<lane>(_mm256_load_si256(reinterpret_cast<const __m256i*>(bytes + i)), splat);
+            __m256i e1 = _simd_cmpeq256<lane>(_mm256_load_si256(reinterpret_cast<const __m256i*>(bytes + i + 32)), splat);
+            __m256i e2 = _simd_cmpeq256<lane>(_mm256_load_si256(reinterpret_cast<const __m256i*>(bytes + i + 64)), splat);
+            __m256i e3 = _simd_cmpeq256<lane>(_mm256_load_si256(reinterpret_cast<const __m256i*>(bytes + i + 96)), splat);
+            __m256i any = _mm256_or_si256(_mm256_or_si256(e0, e1), _mm256_or_si256(e2, e3));
+            if(!_mm256_testz_si256(any, any)) [[unlikely]]{
+                std::uint64_t lo = static_cast<std::uint32_t>(_mm256_movemask_epi8(e0)) | static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(e1))) << 32;
+                if(lo)
+                    return (i + std::countr_zero(lo)) / sizeof(T);
+                std::uint64_t hi = static_cast<std::uint32_t>(_mm256_movemask_epi8(e2)) | static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(e3))) << 32;
+                return (i + 64 + std::countr_zero(hi)) / sizeof(T);
+            }
+        }
+        for(; i + 32 <= len; i += 32){
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_simd_cmpeq256<lane>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i)), splat)));
+            if(mask)
+                return (i + std::countr_zero(mask)) / sizeof(T);
+        }
+#elif defined(_CRABI_SIMD_SSE2)
+        const __m128i splat = _simd_splat128(needle);
+        if(len >= 64){
+            // Check the first (unaligned) vector, then continue from the next 16-byte boundary so that the main loop can use aligned loads.
+            // This stays on a lane boundary, since `bytes` is aligned to `sizeof(T)`
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_simd_cmpeq128<lane>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes)), splat)));
+            if(mask)
+                return std::countr_zero(mask) / sizeof(T);
+            i = 16 - (reinterpret_cast<std::uintptr_t>(bytes) & 15);
+        }
+        for(; i + 64 <= len; i += 64){
+            __m128i e0 = _simd_cmpeq128<lane>(_mm_load_si128(reinterpret_cast<const __m128i*>(bytes + i)), splat);
+            __m128i e1 = _simd_cmpeq128<lane>(_mm_load_si128(reinterpret_cast<const __m128i*>(bytes + i + 16)), splat);
+            __m128i e2 = _simd_cmpeq128<lane>(_mm_load_si128(reinterpret_cast<const __m128i*>(bytes + i + 32)), splat);
+            __m128i e3 = _simd_cmpeq128<lane>(_mm_load_si128(reinterpret_cast<const __m128i*>(bytes + i + 48)), splat);
+            __m128i any = _mm_or_si128(_mm_or_si128(e0, e1), _mm_or_si128(e2, e3));
+            if(_mm_movemask_epi8(any)) [[unlikely]]{
+                std::uint64_t mask = static_cast<std::uint64_t>(_mm_movemask_epi8(e0))
+                    | static_cast<std::uint64_t>(_mm_movemask_epi8(e1)) << 16
+                    | static_cast<std::uint64_t>(_mm_movemask_epi8(e2)) << 32
+                    | static_cast<std::uint64_t>(_mm_movemask_epi8(e3)) << 48;
+                return (i + std::countr_zero(mask)) / sizeof(T);
+            }
+        }
+        for(; i + 16 <= len; i += 16){
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_simd_cmpeq128<lane>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i)), splat)));
+            if(mask)
+                return (i + std::countr_zero(mask)) / sizeof(T);
+        }
+#endif
+        for(std::size_t j = i / sizeof(T); j < n; j++)
+            if(std::bit_cast<lane>(p[j]) == needle)
+                return j;
+        return n;
+    }
+
+    /// Returns the index of the first occurrence of `[needle, needle+m)` in `[p, p+n)`, or `n` if there is none.
+    /// Candidates are the positions where both the first and the last byte of the needle match, which are then compared in full
+    inline std::size_t _simd_find_bytes(const unsigned char* p, std::size_t n, const unsigned char* needle, std::size_t m) noexcept{
+        if(m == 0)
+            return 0;
+        if(m > n)
+            return n;
+        if(m == 1){
+            const void* found = std::memchr(p, needle[0], n);
+            return found ? static_cast<std::size_t>(static_cast<const unsigned char*>(found) - p) : n;
+        }
+        const std::size_t last = n - m;
+        std::size_t i = 0;
+#if defined(_CRABI_SIMD_AVX2)
+        const __m256i first_splat = _mm256_set1_epi8(static_cast<char>(needle[0]));
+        const __m256i last_splat = _mm256_set1_epi8(static_cast<char>(needle[m - 1]));
+        for(; i + 32 <= last + 1; i += 32){
+            __m256i f = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), first_splat);
+            __m256i l = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i + m - 1)), last_splat);
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(f, l)));
+            for(; mask; mask &= mask - 1){
+                std::size_t pos = i + std::countr_zero(mask);
+                if(std::memcmp(p + pos + 1, needle + 1, m - 2) == 0)
+                    return pos;
+            }
+        }
+#elif defined(_CRABI_SIMD_SSE2)
+        const __m128i first_splat = _mm_set1_epi8(static_cast<char>(needle[0]));
+        const __m128i last_splat = _mm_set1_epi8(static_cast<char>(needle[m - 1]));
+        for(; i + 16 <= last + 1; i += 16){
+            __m128i f = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), first_splat);
+            __m128i l = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + m - 1)), last_splat);
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(f, l)));
+            for(; mask; mask &= mask - 1){
+                std::size_t pos = i + std::countr_zero(mask);
+                if(std::memcmp(p + pos + 1, needle + 1, m - 2) == 0)
+                    return pos;
+            }
+        }
+#endif
+        while(i <= last){
+            const void* found = std::memchr(p + i, needle[0], last + 1 - i);
+            if(!found)
+                break;
+            std::size_t pos = static_cast<std::size_t>(static_cast<const unsigned char*>(found) - p);
+            if(std::memcmp(p + pos + 1, needle + 1, m - 1) == 0)
+                return pos;
+            i = pos + 1;
+        }
+        return n;
+    }
+
+    /// Returns the number of bytes of `[p, p+n)` which are not UTF-8 continuation bytes (`0b10xxxxxx`), which is the number of characters if the bytes are valid UTF-8
+    inline std::size_t _simd_count_utf8_chars(const unsigned char* p, std::size_t n) noexcept{
+        std::size_t count = 0;
+        std::size_t i = 0;
+#if defined(_CRABI_SIMD_AVX2)
+        const __m256i threshold = _mm256_set1_epi8(-65);
+        while(i + 32 <= n){
+            // The per-byte counters are widened every 255 iterations, before they can overflow
+            __m256i acc = _mm256_setzero_si256();
+            for(std::size_t j = 0; j < 255 && i + 32 <= n; j++, i += 32)
+                acc = _mm256_sub_epi8(acc, _mm256_cmpgt_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), threshold));
+            __m256i sums = _mm256_sad_epu8(acc, _mm256_setzero_si256());
+            count += static_cast<std::size_t>(_mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1) + _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3));
+        }
+#elif defined(_CRABI_SIMD_SSE2)
+        const __m128i threshold = _mm_set1_epi8(-65);
+        while(i + 16 <= n){
+            __m128i acc = _mm_setzero_si128();
+            for(std::size_t j = 0; j < 255 && i + 16 <= n; j++, i += 16)
+                acc = _mm_sub_epi8(acc, _mm_cmpgt_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), threshold));
+            __m128i sums = _mm_sad_epu8(acc, _mm_setzero_si128());
+            count += static_cast<std::size_t>(_mm_cvtsi128_si64(sums) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums)));
+        }
+#endif
+        for(; i < n; i++)
+            count += static_cast<signed char>(p[i]) >= -64;
+        return count;
+    }
+
+    // UTF-8 validation, using the lookup algorithm of Keiser and Lemire ("Validating UTF-8 In Less Than One Instruction Per Byte", 2021).
+    // Each byte is classified by three 16-entry tables, indexed by the high and low nibble of the preceding byte and the high nibble of the byte itself,
+    // each of which sets one bit for every error that is possible given that nibble. A bit that is set in all three is an error.
+    // Sequences of 3 and 4 bytes are checked by comparing the continuation bytes that are required by the lead bytes 2 and 3 positions earlier with those that were found.
+    namespace _utf8{
+        constexpr unsigned char too_short = 1 << 0;
+        constexpr unsigned char too_long = 1 << 1;
+        constexpr unsigned char overlong_3 = 1 << 2;
+        constexpr unsigned char too_large = 1 << 3;
+        constexpr unsigned char surrogate = 1 << 4;
+        constexpr unsigned char overlong_2 = 1 << 5;
+        constexpr unsigned char too_large_1000 = 1 << 6;
+        constexpr unsigned char overlong_4 = 1 << 6;
+        constexpr unsigned char two_conts = 1 << 7;
+        constexpr unsigned char carry = too_short | too_long | two_conts;
+
+        constexpr unsigned char byte_1_high[16] = {
+            // 0_______ ________: ASCII
+            too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+            // 10______ ________: continuation
+            two_conts, two_conts, two_conts, two_conts,
+            // 1100____ ________: 2-byte lead
+            too_short | overlong_2,
+            // 1101____ ________: 2-byte lead
+            too_short,
+            // 1110____ ________: 3-byte lead
+            too_short | overlong_3 | surrogate,
+            // 1111____ ________: 4-byte lead
+            too_short | too_large | too_large_1000 | overlong_4,
+        };
+
+        constexpr unsigned char byte_1_low[16] = {
+            carry | overlong_3 | overlong_2 | overlong_4,
+            carry | overlong_2,
+            carry,
+            carry,
+            carry | too_large,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000 | surrogate,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+        };
+
+        constexpr unsigned char byte_2_high[16] = {
+            // ________ 0_______: ASCII
+            too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+            // ________ 1000____
+            too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+            // ________ 1001____
+            too_long | overlong_2 | two_conts | overlong_3 | too_large,
+            // ________ 101_____
+            too_long | overlong_2 | two_conts | surrogate | too_large,
+            too_long | overlong_2 | two_conts | surrogate | too_large,
+            // ________ 11______: lead
+            too_short, too_short, too_short, too_short,
+        };
+    }
+
+#ifdef _CRABI_SIMD_DISPATCH
+    // Vectors are passed between these and the member functions of `Checker`, which GCC warns about because they are not compiled for the instruction set of `Checker`.
+    // They are always inlined into the kernel for that instruction set, so no vector is ever passed across a call
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+    /// Checks the 64 bytes at `b` with `Checker`
+    template<typename Checker> _CRABI_SIMD_ALWAYS_INLINE inline void _simd_utf8_check_block(Checker& checker, const unsigned char* b) noexcept{
+        using vec = typename Checker::vec;
+        constexpr std::size_t per_block = 64 / Checker::width;
+        vec in[per_block];
+        for(std::size_t k = 0; k < per_block; k++)
+            in[k] = Checker::_load(b + k * Checker::width);
+        vec any = in[0];
+        for(std::size_t k = 1; k < per_block; k++)
+            any = Checker::_or(any, in[k]);
+        if(Checker::_is_ascii(any)){
+            // A sequence that was incomplete at the end of the previous block cannot be completed by ASCII
+            checker._m_error = Checker::_or(checker._m_error, checker._m_prev_incomplete);
+            checker._m_prev_input = in[per_block - 1];
+        }else{
+            for(std::size_t k = 0; k < per_block; k++)
+                checker._check(in[k]);
+            checker._m_prev_incomplete = Checker::_incomplete(in[per_block - 1]);
+        }
+    }
+
+    /// Validates `[p, p+n)` as UTF-8 with `Checker`, as described for `_simd_validate_utf8`.
+    /// This and `_simd_utf8_check_block` are always inlined into the kernel for the instruction set of `Checker`, so that they are compiled for that instruction set
+    template<typename Checker> _CRABI_SIMD_ALWAYS_INLINE inline std::size_t _simd_validate_utf8_blocks(const unsigned char* p, std::size_t n) noexcept{
+        Checker checker;
+        std::size_t i = 0;
+        std::size_t block = 0;
+        for(; i + 64 <= n; i += 64){
+            block = i;
+            _simd_utf8_check_block(checker, p + i);
+            if(checker._has_error()) [[unlikely]]
+                return block;
+        }
+        if(i < n){
+            // The tail is padded with ASCII, which completes no sequence
+            alignas(64) unsigned char tail[64] = {};
+            std::memcpy(tail, p + i, n - i);
+            block = i;
+            _simd_utf8_check_block(checker, tail);
+        }
+        checker._m_error = Checker::_or(checker._m_error, checker._m_prev_incomplete);
+        return checker._has_error() ? block : n;
+    }
+#ifdef _CRABI_SIMD_DISPATCH
+#pragma GCC diagnostic pop
+#endif
+
+#if defined(_CRABI_SIMD_AVX2) || defined(_CRABI_SIMD_DISPATCH)
+#ifndef _CRABI_SIMD_AVX2
+    _CRABI_SIMD_TARGET_PUSH("avx2")
+#endif
+    struct _utf8_checker_avx2{
+        using vec = __m256i;
+        static constexpr std::size_t width = 32;
+
+        vec _m_error;
+        vec _m_prev_input;
+        vec _m_prev_incomplete;
+
+        // Not a default member initializer, which would be compiled outside of `_CRABI_SIMD_TARGET_PUSH`
+        _utf8_checker_avx2() noexcept : _m_error{_mm256_setzero_si256()}, _m_prev_input{_mm256_setzero_si256()}, _m_prev_incomplete{_mm256_setzero_si256()}{}
+
+        static vec _table(const unsigned char (&tbl)[16]) noexcept{
+            return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(tbl)));
+        }
+
+        static vec _load(const unsigned char* p) noexcept{
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        }
+
+        static bool _is_ascii(vec v) noexcept{
+            return !_mm256_movemask_epi8(v);
+        }
+
+        static vec _or(vec a, vec b) noexcept{
+            return _mm256_or_si256(a, b);
+        }
+
+        /// The bytes `N` positions before each byte of `input`
+        template<int N> static vec _prev(vec input, vec prev_input) noexcept{
+            return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev_input, input, 0x21), 16 - N);
+        }
+
+        static vec _high_nibbles(vec v) noexcept{
+            return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+        }
+
+        void _check(vec input) noexcept{
+            vec prev1 = _prev<1>(input, _m_prev_input);
+            vec special = _mm256_and_si256(_mm256_and_si256(
+                _mm256_shuffle_epi8(_table(_utf8::byte_1_high), _high_nibbles(prev1)),
+                _mm256_shuffle_epi8(_table(_utf8::byte_1_low), _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)))),
+                _mm256_shuffle_epi8(_table(_utf8::byte_2_high), _high_nibbles(input)));
+            // Only `111_____` is at least 0x80 after subtracting 0x60, and only `1111____` after subtracting 0x70
+            vec must_be_continuation = _mm256_or_si256(
+                _mm256_subs_epu8(_prev<2>(input, _m_prev_input), _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80))),
+                _mm256_subs_epu8(_prev<3>(input, _m_prev_input), _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80))));
+            vec lengths = _mm256_xor_si256(_mm256_and_si256(must_be_continuation, _mm256_set1_epi8(static_cast<char>(0x80))), special);
+            _m_error = _mm256_or_si256(_m_error, lengths);
+            _m_prev_input = input;
+        }
+
+        /// Non-zero in the last three bytes if they begin a sequence which does not end within `input`
+        static vec _incomplete(vec input) noexcept{
+            const vec max = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+            return _mm256_subs_epu8(input, max);
+        }
+
+        bool _has_error() const noexcept{
+            return !_mm256_testz_si256(_m_error, _m_error);
+        }
+    };
+
+    inline std::size_t _simd_validate_utf8_avx2(const unsigned char* p, std::size_t n) noexcept{
+        return _simd_validate_utf8_blocks<_utf8_checker_avx2>(p, n);
+    }
+#ifndef _CRABI_SIMD_AVX2
+    _CRABI_SIMD_TARGET_POP()
+#endif
+#endif
+
+#if defined(_CRABI_SIMD_SSSE3) || defined(_CRABI_SIMD_DISPATCH)
+#ifndef _CRABI_SIMD_SSSE3
+    _CRABI_SIMD_TARGET_PUSH("ssse3")
+#endif
+    struct _utf8_checker_ssse3{
+        using vec = __m128i;
+        static constexpr std::size_t width = 16;
+
+        vec _m_error;
+        vec _m_prev_input;
+        vec _m_prev_incomplete;
+
+        _utf8_checker_ssse3() noexcept : _m_error{_mm_setzero_si128()}, _m_prev_input{_mm_setzero_si128()}, _m_prev_incomplete{_mm_setzero_si128()}{}
+
+        static vec _table(const unsigned char (&tbl)[16]) noexcept{
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(tbl));
+        }
+
+        static vec _load(const unsigned char* p) noexcept{
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        }
+
+        static bool _is_ascii(vec v) noexcept{
+            return !_mm_movemask_epi8(v);
+        }
+
+        static vec _or(vec a, vec b) noexcept{
+            return _mm_or_si128(a, b);
+        }
+
+        template<int N> static vec _prev(vec input, vec prev_input) noexcept{
+            return _mm_alignr_epi8(input, prev_input, 16 - N);
+        }
+
+        static vec _high_nibbles(vec v) noexcept{
+            return _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F));
+        }
+
+        void _check(vec input) noexcept{
+            vec prev1 = _prev<1>(input, _m_prev_input);
+            vec special = _mm_and_si128(_mm_and_si128(
+                _mm_shuffle_epi8(_table(_utf8::byte_1_high), _high_nibbles(prev1)),
+                _mm_shuffle_epi8(_table(_utf8::byte_1_low), _mm_and_si128(prev1, _mm_set1_epi8(0x0F)))),
+                _mm_shuffle_epi8(_table(_utf8::byte_2_high), _high_nibbles(input)));
+            vec must_be_continuation = _mm_or_si128(
+                _mm_subs_epu8(_prev<2>(input, _m_prev_input), _mm_set1_epi8(static_cast<char>(0xE0 - 0x80))),
+                _mm_subs_epu8(_prev<3>(input, _m_prev_input), _mm_set1_epi8(static_cast<char>(0xF0 - 0x80))));
+            vec lengths = _mm_xor_si128(_mm_and_si128(must_be_continuation, _mm_set1_epi8(static_cast<char>(0x80))), special);
+            _m_error = _mm_or_si128(_m_error, lengths);
+            _m_prev_input = input;
+        }
+
+        static vec _incomplete(vec input) noexcept{
+            const vec max = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+            return _mm_subs_epu8(input, max);
+        }
+
+        bool _has_error() const noexcept{
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(_m_error, _mm_setzero_si128())) != 0xFFFF;
+        }
+    };
+
+    inline std::size_t _simd_validate_utf8_ssse3(const unsigned char* p, std::size_t n) noexcept{
+        return _simd_validate_utf8_blocks<_utf8_checker_ssse3>(p, n);
+    }
+#ifndef _CRABI_SIMD_SSSE3
+    _CRABI_SIMD_TARGET_POP()
+#endif
+#endif
+
+    /// Skips the blocks of 64 ASCII bytes at the start of `[p, p+n)`, and returns the position of the first block that is not ASCII
+    inline std::size_t _simd_validate_utf8_ascii(const unsigned char* p, std::size_t n) noexcept{
+        std::size_t i = 0;
+#if defined(_CRABI_SIMD_SSE2)
+        for(; i + 64 <= n; i += 64){
+            __m128i any = _mm_or_si128(
+                _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + 16))),
+                _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + 32)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + 48))));
+            if(_mm_movemask_epi8(any))
+                return i;
+        }
+#endif
+        // The remaining bytes (all of them, without SSE2) are left to the scalar validator
+        (void)p;
+        (void)n;
+        return i;
+    }
+
+    /// Validates `[p, p+n)` as UTF-8, 64 bytes at a time.
+    /// Returns `n` if the input is valid. Otherwise, returns a position `i` such that the input is valid up to the start of the last character that begins before `i`,
+    /// from where it must be validated by the scalar validator to find the error.
+    /// Without SSSE3, only blocks of ASCII are skipped, and `i` is the first block that contains a non-ASCII byte.
+    ///
+    /// With `_CRABI_SIMD_DISPATCH`, the widest kernel that the CPU supports is selected on the first call
+    inline std::size_t _simd_validate_utf8(const unsigned char* p, std::size_t n) noexcept{
+#if defined(_CRABI_SIMD_AVX2)
+        return _simd_validate_utf8_avx2(p, n);
+#elif defined(_CRABI_SIMD_DISPATCH)
+        using kernel = std::size_t (*)(const unsigned char*, std::size_t) noexcept;
+        static const kernel selected = []() noexcept -> kernel{
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("avx2"))
+                return _simd_validate_utf8_avx2;
+#ifndef _CRABI_SIMD_SSSE3
+            if(!__builtin_cpu_supports("ssse3"))
+                return _simd_validate_utf8_ascii;
+#endif
+            return _simd_validate_utf8_ssse3;
+        }();
+        return selected(p, n);
+#elif defined(_CRABI_SIMD_SSSE3)
+        return _simd_validate_utf8_ssse3(p, n);
+#else
+        return _simd_validate_utf8_ascii(p, n);
+#endif
+    }
+}
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include <crabi/_except.hxx>
+
+namespace crabi{
+    /// An allocator that uses the C heap (`malloc`/`aligned_alloc`/`realloc`/`free`).
+    ///
+    /// On Unix targets, this is the same heap used by Rust's `std::alloc::System` allocator, so memory allocated by `system_allocator` can be
+    /// released by Rust code using `System` (and vice versa). This is the default allocator of `crabi::vec` and `crabi::boxed_slice`.
+    template<typename T> struct system_allocator{
+    private:
+        static constexpr bool _over_aligned = alignof(T) > alignof(std::max_align_t);
+    public:
+        using value_type = T;
+        using is_always_equal = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+
+        constexpr system_allocator() noexcept = default;
+        template<typename U> constexpr system_allocator(const system_allocator<U>&) noexcept{}
+
+        [[nodiscard]] T* allocate(std::size_t n){
+            if (n > std::size_t(-1) / sizeof(T)) [[unlikely]]
+                _CRABI_THROW(std::bad_array_new_length{});
+            void* ptr;
+            if constexpr(_over_aligned)
+                ptr = std::aligned_alloc(alignof(T), (n * sizeof(T) + alignof(T) - 1) & ~(alignof(T) - 1));
+            else
+                ptr = std::malloc(n * sizeof(T));
+            if (!ptr) [[unlikely]]
+                _CRABI_THROW(std::bad_alloc{});
+            return static_cast<T*>(ptr);
+        }
+
+        void deallocate(T* ptr, std::size_t) noexcept{
+            std::free(ptr);
+        }
+
+        /// Resizes the allocation at `ptr` from `old_n` to `new_n` elements, preserving its contents. Only valid for trivially copyable `T`.
+        /// Uses `realloc`, which can often grow the allocation in place
+        [[nodiscard]] T* reallocate(T* ptr, std::size_t old_n, std::size_t new_n) requires std::is_trivially_copyable_v<T>{
+            if constexpr(_over_aligned){
+                T* nptr = this->allocate(new_n);
+                std::memcpy(nptr, ptr, std::min(old_n, new_n) * sizeof(T));
+                this->deallocate(ptr, old_n);
+                return nptr;
+            }else{
+                if (new_n > std::size_t(-1) / sizeof(T)) [[unlikely]]
+                    _CRABI_THROW(std::bad_array_new_length{});
+                void* nptr = std::realloc(ptr, new_n * sizeof(T));
+                if (!nptr) [[unlikely]]
+                    _CRABI_THROW(std::bad_alloc{});
+                return static_cast<T*>(nptr);
+            }
+        }
+
+        template<typename U> constexpr friend bool operator==(const system_allocator&, const system_allocator<U>&) noexcept{
+            return true;
+        }
+    };
+
+    /// A bump (monotonic) arena. Allocation advances a pointer within the current chunk, and individual deallocations are ignored
+    /// (except for the most recent allocation, which is rolled back). All memory is released by `reset()` or when the arena is destroyed.
+    ///
+    /// Intended for per-request scratch memory: allocate freely while handling the request, then `reset()` the arena.
+    /// `bump_arena` is not thread-safe.
+    struct bump_arena{
+    private:
+        struct _chunk{
+            _chunk* _m_prev;
+            std::size_t _m_size;
+        };
+        _chunk* _m_chunk;
+        unsigned char* _m_cur;
+        unsigned char* _m_end;
+        unsigned char* _m_last;
+        std::size_t _m_next_size;
+
+        static constexpr std::size_t _chunk_header = (sizeof(_chunk) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+        void _grow(std::size_t size, std::size_t align){
+            std::size_t need = size + align + _chunk_header;
+            std::size_t chunk_size = std::max(_m_next_size, need);
+            void* mem = std::malloc(chunk_size);
+            if (!mem) [[unlikely]]
+                _CRABI_THROW(std::bad_alloc{});
+            _chunk* chunk = ::new(mem) _chunk{_m_chunk, chunk_size};
+            _m_chunk = chunk;
+            _m_cur = static_cast<unsigned char*>(mem) + _chunk_header;
+            _m_end = static_cast<unsigned char*>(mem) + chunk_size;
+            _m_last = nullptr;
+            _m_next_size = chunk_size * 2;
+        }
+
+        void _release_all() noexcept{
+            while (_m_chunk){
+                _chunk* prev = _m_chunk->_m_prev;
+                std::free(_m_chunk);
+                _m_chunk = prev;
+            }
+        }
+    public:
+        static constexpr std::size_t default_chunk_size = 64 * 1024;
+
+        explicit bump_arena(std::size_t initial_chunk_size = default_chunk_size) noexcept :
+            _m_chunk{}, _m_cur{}, _m_end{}, _m_last{}, _m_next_size{std::max(initial_chunk_size, _chunk_header + alignof(std::max_align_t))}{}
+
+        bump_arena(const bump_arena&) = delete;
+        bump_arena& operator=(const bump_arena&) = delete;
+
+        ~bump_arena() noexcept{
+            this->_release_all();
+        }
+
+        [[nodiscard]] void* allocate(std::size_t size, std::size_t align = alignof(std::max_align_t)){
+            std::uintptr_t cur = reinterpret_cast<std::uintptr_t>(_m_cur);
+            std::uintptr_t aligned = (cur + align - 1) & ~(std::uintptr_t(align) - 1);
+            if (!_m_cur || aligned + size > reinterpret_cast<std::uintptr_t>(_m_end)) [[unlikely]]{
+                this->_grow(size, align);
+                cur = reinterpret_cast<std::uintptr_t>(_m_cur);
+                aligned = (cur + align - 1) & ~(std::uintptr_t(align) - 1);
+            }
+            _m_last = reinterpret_cast<unsigned char*>(aligned);
+            _m_cur = _m_last + size;
+            return _m_last;
+        }
+
+        /// Releases `ptr` if it was the most recent allocation, otherwise does nothing
+        void deallocate(void* ptr, std::size_t) noexcept{
+            if (ptr && ptr == _m_last){
+                _m_cur = _m_last;
+                _m_last = nullptr;
+            }
+        }
+
+        /// Grows or shrinks the most recent allocation in place if possible, and otherwise allocates a new block and copies `old_size` bytes to it.
+        [[nodiscard]] void* reallocate(void* ptr, std::size_t old_size, std::size_t new_size, std::size_t align = alignof(std::max_align_t)){
+            if (ptr && ptr == _m_last && static_cast<unsigned char*>(ptr) + new_size <= _m_end){
+                _m_cur = _m_last + new_size;
+                return ptr;
+            }
+            void* nptr = this->allocate(new_size, align);
+            if (ptr)
+                std::memcpy(nptr, ptr, std::min(old_size, new_size));
+            return nptr;
+        }
+
+        /// Releases every allocation. The most recent chunk is retained for reuse
+        void reset() noexcept{
+            if (!_m_chunk)
+                return;
+            _chunk* keep = _m_chunk;
+            _m_chunk = keep->_m_prev;
+            this->_release_all();
+            keep->_m_prev = nullptr;
+            _m_chunk = keep;
+            _m_cur = reinterpret_cast<unsigned char*>(keep) + _chunk_header;
+            _m_end = reinterpret_cast<unsigned char*>(keep) + keep->_m_size;
+            _m_last = nullptr;
+        }
+    };
+
+    /// A size-class pool. Allocations of up to `max_pooled_size` bytes are rounded up to a power of two and served from per-class free lists,
+    /// which are refilled from a `bump_arena`. Larger allocations go directly to `malloc`.
+    ///
+    /// Freed blocks are reused by later allocations of the same class, so steady-state allocation does not reach `malloc`.
+    /// `size_class_pool` is not thread-safe.
+    struct size_class_pool{
+    private:
+        struct _free_block{
+            _free_block* _m_next;
+        };
+        static constexpr std::size_t _min_shift = 4;
+        static constexpr std::size_t _max_shift = 12;
+        static constexpr std::size_t _classes = _max_shift - _min_shift + 1;
+
+        bump_arena _m_arena;
+        _free_block* _m_free[_classes]{};
+
+        static constexpr std::size_t _class_of(std::size_t size) noexcept{
+            std::size_t cls = 0;
+            while ((std::size_t{1} << (cls + _min_shift)) < size)
+                cls++;
+            return cls;
+        }
+    public:
+        static constexpr std::size_t max_pooled_size = std::size_t{1} << _max_shift;
+
+        explicit size_class_pool(std::size_t chunk_size = bump_arena::default_chunk_size) noexcept : _m_arena{chunk_size}{}
+
+        size_class_pool(const size_class_pool&) = delete;
+        size_class_pool& operator=(const size_class_pool&) = delete;
+
+        [[nodiscard]] void* allocate(std::size_t size, std::size_t align = alignof(std::max_align_t)){
+            if (size > max_pooled_size || align > (std::size_t{1} << _min_shift)) [[unlikely]]{
+                void* ptr = align > alignof(std::max_align_t) ? std::aligned_alloc(align, (size + align - 1) & ~(align - 1)) : std::malloc(size);
+                if (!ptr) [[unlikely]]
+                    _CRABI_THROW(std::bad_alloc{});
+                return ptr;
+            }
+            std::size_t cls = _class_of(size);
+            if (_free_block* block = _m_free[cls]){
+                _m_free[cls] = block->_m_next;
+                return block;
+            }
+            return _m_arena.allocate(std::size_t{1} << (cls + _min_shift), std::size_t{1} << _min_shift);
+        }
+
+        void deallocate(void* ptr, std::size_t size, std::size_t align = alignof(std::max_align_t)) noexcept{
+            if (!ptr)
+                return;
+            if (size > max_pooled_size || align > (std::size_t{1} << _min_shift)) [[unlikely]]{
+                std::free(ptr);
+                return;
+            }
+            std::size_t cls = _class_of(size);
+            _m_free[cls] = ::new(ptr) _free_block{_m_free[cls]};
+        }
+    };
+
+    namespace _detail{
+        /// The common implementation of allocators that refer to a memory resource `R` with `allocate(size, align)`/`deallocate(ptr, size[, align])`
+        template<typename T, typename R> struct _resource_allocator{
+        protected:
+            R* _m_resource;
+        public:
+            using value_type = T;
+            using propagate_on_container_copy_assignment = std::true_type;
+            using propagate_on_container_move_assignment = std::true_type;
+            using propagate_on_container_swap = std::true_type;
+
+            constexpr explicit _resource_allocator(R& resource) noexcept : _m_resource{std::addressof(resource)}{}
+
+            [[nodiscard]] T* allocate(std::size_t n){
+                if (n > std::size_t(-1) / sizeof(T)) [[unlikely]]
+                    _CRABI_THROW(std::bad_array_new_length{});
+                return static_cast<T*>(_m_resource->allocate(n * sizeof(T), alignof(T)));
+            }
+
+            void deallocate(T* ptr, std::size_t n) noexcept{
+                _m_resource->deallocate(ptr, n * sizeof(T));
+            }
+
+            constexpr R& resource() const noexcept{
+                return *_m_resource;
+            }
+        };
+    }
+
+    /// An allocator that allocates from a `bump_arena`
+    template<typename T> struct arena_allocator : _detail::_resource_allocator<T, bump_arena>{
+        using _detail::_resource_allocator<T, bump_arena>::_resource_allocator;
+        template<typename U> constexpr arena_allocator(const arena_allocator<U>& other) noexcept : arena_allocator(other.resource()){}
+
+        /// Grows the most recent allocation in place where possible. Only valid for trivially copyable `T`
+        [[nodiscard]] T* reallocate(T* ptr, std::size_t old_n, std::size_t new_n) requires std::is_trivially_copyable_v<T>{
+            if (new_n > std::size_t(-1) / sizeof(T)) [[unlikely]]
+                _CRABI_THROW(std::bad_array_new_length{});
+            return static_cast<T*>(this->_m_resource->reallocate(ptr, old_n * sizeof(T), new_n * sizeof(T), alignof(T)));
+        }
+
+        template<typename U> constexpr friend bool operator==(const arena_allocator& a, const arena_allocator<U>& b) noexcept{
+            return std::addressof(a.resource()) == std::addressof(b.resource());
+        }
+    };
+
+    /// An allocator that allocates from a `size_class_pool`
+    template<typename T> struct pool_allocator : _detail::_resource_allocator<T, size_class_pool>{
+        using _detail::_resource_allocator<T, size_class_pool>::_resource_allocator;
+        template<typename U> constexpr pool_allocator(const pool_allocator<U>& other) noexcept : pool_allocator(other.resource()){}
+
+        void deallocate(T* ptr, std::size_t n) noexcept{
+            this->_m_resource->deallocate(ptr, n * sizeof(T), alignof(T));
+        }
+
+        template<typename U> constexpr friend bool operator==(const pool_allocator& a, const pool_allocator<U>& b) noexcept{
+            return std::addressof(a.resource()) == std::addressof(b.resource());
+        }
+    };
+}
@@ -4,9 +4,11 @@
 #include <iterator>
 #include <ranges>
 #include <algorithm>
+#include <compare>
 #include <rusty/concepts.hxx>
 #include <rusty/type_traits.hxx>
 #include <crabi/option.hxx>
+#include <crabi/result.hxx>
 #include <stdexcept>
 #include <format>
 #include <tuple>
@@ -98,15 +100,27 @@ namespace crabi{
         constexpr reference at(std::size_t l) {
             using namespace std::string_view_literals;
             if (l >= N) [[unlikely]]
-                throw std::out_of_range{std::format("Index {} out of bounds for array with length {}"sv, l, N)};
+                _CRABI_THROW(std::out_of_range{std::format("Index {} out of bounds for array with length {}"sv, l, N)});
             return this->data()[l];
         }
 
         constexpr crabi::option<reference> get_ref(std::size_t l) noexcept {
             if (l >= N)
-                return crabi::none;
+                return crabi::option<reference>{};
             else
-                return crabi::some(this->data()[1]);
+                return crabi::option<reference>{this->data()[l]};
+        }
+
+        /// Returns the element at `l`, or an empty `option` if `l` is out of bounds. Equivalent to `get_ref`
+        constexpr crabi::option<reference> try_get(std::size_t l) noexcept {
+            return this->get_ref(l);
+        }
+
+        /// Returns the element at `l`, or an `index_error` if `l` is out of bounds. Unlike `at`, this never throws or allocates
+        constexpr crabi::result<reference, crabi::index_error> checked_at(std::size_t l) noexcept {
+            if (l >= N) [[unlikely]]
+                return crabi::err(crabi::index_error{l, N});
+            return this->data()[l];
         }
 
         constexpr const_reference operator[](std::size_t l) const noexcept{
@@ -116,15 +130,27 @@ namespace crabi{
         constexpr const_reference at(std::size_t l) const {
             using namespace std::string_view_literals;
             if (l >= N) [[unlikely]]
-                throw std::out_of_range{std::format("Index {} out of bounds for array with length {}"sv, l, N)};
+                _CRABI_THROW(std::out_of_range{std::format("Index {} out of bounds for array with length {}"sv, l, N)});
             return this->data()[l];
         }
 
         constexpr crabi::option<const_reference> get_ref(std::size_t l) const noexcept {
             if (l >= N)
-                return crabi::none;
+                return crabi::option<const_reference>{};
             else
-                return crabi::some(this->data()[1]);
+                return crabi::option<const_reference>{this->data()[l]};
+        }
+
+        /// Returns the element at `l`, or an empty `option` if `l` is out of bounds. Equivalent to `get_ref`
+        constexpr crabi::option<const_reference> try_get(std::size_t l) const noexcept {
+            return this->get_ref(l);
+        }
+
+        /// Returns the element at `l`, or an `index_error` if `l` is out of bounds. Unlike `at`, this never throws or allocates
+        constexpr crabi::result<const_reference, crabi::index_error> checked_at(std::size_t l) const noexcept {
+            if (l >= N) [[unlikely]]
+                return crabi::err(crabi::index_error{l, N});
+            return this->data()[l];
         }
 
         
@@ -144,18 +170,26 @@ namespace crabi{
             return std::move(this->data()[I]);
         }
 
+        constexpr friend bool operator==(const array& a, const array& b) noexcept(noexcept(std::declval<const T&>() == std::declval<const T&>())) requires std::equality_comparable<T>{
+            return std::ranges::equal(a, b);
+        }
+
+        constexpr friend auto operator<=>(const array& a, const array& b) noexcept(noexcept(std::declval<const T&>() <=> std::declval<const T&>())) requires std::three_way_comparable<T>{
+            return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end());
+        }
+
         template<std::size_t I> requires (I < N) friend reference get(array<T, N>& arr) noexcept{
-            return arr.get();
+            return arr.template get<I>();
         }
         template<std::size_t I> requires (I < N) friend const_reference get(const array<T,N>& arr) noexcept{
-            return arr.get();
+            return arr.template get<I>();
         }
 
         template<std::size_t I> requires (I < N) friend T&& get(array<T, N>&& arr) noexcept{
-            return std::move(arr.get());
+            return std::move(arr).template get<I>();
         }
         template<std::size_t I> requires (I < N) friend const_reference get(const array<T,N>&& arr) noexcept{
-            return std::move(arr.get());
+            return std::move(arr).template get<I>();
         }
     };
 
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include <crabi/option.hxx>
+#include <crabi/result.hxx>
+
+namespace crabi{
+    namespace _detail{
+        /// The unsigned integer with the same size as an `option` of `N` bytes, which the `option` is stored in by `atomic_option`
+        template<std::size_t N> struct _atomic_option_word{};
+        template<> struct _atomic_option_word<1>{
+            using type = std::uint8_t;
+        };
+        template<> struct _atomic_option_word<2>{
+            using type = std::uint16_t;
+        };
+        template<> struct _atomic_option_word<4>{
+            using type = std::uint32_t;
+        };
+        template<> struct _atomic_option_word<8>{
+            using type = std::uint64_t;
+        };
+
+        template<typename T> using _atomic_option_word_t = typename _atomic_option_word<sizeof(option<T>)>::type;
+
+        /// Satisfied if `option<T>` is a single word (a reference, or a niche-optimized `T`) with no padding, which the target can operate on without a lock.
+        /// Without unique object representations, two equal `option<T>`s could have different bits, and a compare-exchange could fail spuriously forever
+        template<typename T> concept _atomic_option_storable =
+            (std::is_reference_v<T> || (_optional_storage_niche<T> && std::is_trivially_copyable_v<T> && std::has_unique_object_representations_v<T>))
+            && requires{ typename _atomic_option_word_t<T>; }
+            && std::atomic<_atomic_option_word_t<T>>::is_always_lock_free;
+
+        /// The failure ordering of a compare-exchange given a single ordering, as for `std::atomic::compare_exchange_strong`
+        constexpr std::memory_order _cas_failure_order(std::memory_order order) noexcept{
+            switch(order){
+            case std::memory_order_acq_rel:
+                return std::memory_order_acquire;
+            case std::memory_order_release:
+                return std::memory_order_relaxed;
+            default:
+                return order;
+            }
+        }
+    }
+
+    /// An `option<T>` that can be accessed by multiple threads, without a lock.
+    /// This is available when `option<T>` is stored in a single lock-free word: `option<T&>`, and `option<T>` for niche-optimized `T`
+    /// such as `ref<U>`, `ref_mut<U>`, `non_null<U>`, `bool`, and `char32_t`. The `option` is stored as its bits, so an empty `atomic_option` holds the niche value of `T`.
+    ///
+    /// Operations that would copy the contained value (`load`, `compare_exchange`, and `get_or_init`) require `T` to be copyable, so that
+    /// an `atomic_option<ref_mut<U>>` only ever hands its value to one thread, through `take` or `replace`.
+    template<typename T> requires _detail::_atomic_option_storable<T> struct atomic_option{
+    private:
+        using _word = _detail::_atomic_option_word_t<T>;
+
+        static constexpr bool _copyable = std::is_reference_v<T> || std::copy_constructible<T>;
+
+        std::atomic<_word> _m_word;
+
+        static constexpr _word _empty_word() noexcept{
+            if constexpr(std::is_reference_v<T>)
+                return 0;
+            else if constexpr(std::is_pointer_v<optional_niche_t<T>>){
+                // Pointers cannot be converted by `std::bit_cast` in a constant expression, but a null pointer is all zero bits
+                static_assert(optional_niche_v<T> == nullptr, "atomic_option requires the niche of a pointer to be nullptr");
+                return 0;
+            }else
+                return std::bit_cast<_word>(optional_niche_v<T>);
+        }
+
+        static _word _to_word(const option<T>& val) noexcept{
+            return std::bit_cast<_word>(val);
+        }
+
+        static option<T> _from_word(_word w) noexcept{
+            return std::bit_cast<option<T>>(w);
+        }
+    public:
+        using value_type = option<T>;
+
+        static constexpr bool is_always_lock_free = true;
+
+        /// Constructs an empty `atomic_option`. This is a constant initializer, so that an `atomic_option` can be a `constinit` lazily initialized global
+        constexpr atomic_option(std::nullopt_t = std::nullopt) noexcept : _m_word{_empty_word()}{}
+
+        explicit atomic_option(option<T> val) noexcept : _m_word{_to_word(val)}{}
+
+        atomic_option(const atomic_option&) = delete;
+        atomic_option& operator=(const atomic_option&) = delete;
+
+        bool is_lock_free() const noexcept{
+            return true;
+        }
+
+        option<T> load(std::memory_order order = std::memory_order_seq_cst) const noexcept requires _copyable{
+            return _from_word(_m_word.load(order));
+        }
+
+        void store(option<T> val, std::memory_order order = std::memory_order_seq_cst) noexcept{
+            _m_word.store(_to_word(val), order);
+        }
+
+        /// Stores `val` and returns the previous value, as `std::atomic::exchange`
+        option<T> replace(option<T> val, std::memory_order order = std::memory_order_seq_cst) noexcept{
+            return _from_word(_m_word.exchange(_to_word(val), order));
+        }
+
+        /// Empties the `atomic_option` and returns the previous value, by exchanging with the niche value
+        option<T> take(std::memory_order order = std::memory_order_seq_cst) noexcept{
+            return _from_word(_m_word.exchange(_empty_word(), order));
+        }
+
+        /// Stores `desired` if the current value is `current`, as Rust's `AtomicPtr::compare_exchange`.
+        /// Returns the previous value, as an `ok` if it was `current` (and `desired` was stored), and as an `err` otherwise
+        result<option<T>, option<T>> compare_exchange(option<T> current, option<T> desired, std::memory_order success, std::memory_order failure) noexcept requires _copyable{
+            _word w = _to_word(current);
+            if(_m_word.compare_exchange_strong(w, _to_word(desired), success, failure))
+                return ok(std::move(current));
+            else
+                return err(_from_word(w));
+        }
+
+        result<option<T>, option<T>> compare_exchange(option<T> current, option<T> desired, std::memory_order order = std::memory_order_seq_cst) noexcept requires _copyable{
+            return compare_exchange(std::move(current), std::move(desired), order, _detail::_cas_failure_order(order));
+        }
+
+        /// As `compare_exchange`, but may fail even if the current value is `current`, which can be faster in a loop on some targets
+        result<option<T>, option<T>> compare_exchange_weak(option<T> current, option<T> desired, std::memory_order success, std::memory_order failure) noexcept requires _copyable{
+            _word w = _to_word(current);
+            if(_m_word.compare_exchange_weak(w, _to_word(desired), success, failure))
+                return ok(std::move(current));
+            else
+                return err(_from_word(w));
+        }
+
+        result<option<T>, option<T>> compare_exchange_weak(option<T> current, option<T> desired, std::memory_order order = std::memory_order_seq_cst) noexcept requires _copyable{
+            return compare_exchange_weak(std::move(current), std::move(desired), order, _detail::_cas_failure_order(order));
+        }
+
+        /// Returns the contained value, first storing the result of invoking `f` if the `atomic_option` is empty.
+        ///
+        /// If several threads find the `atomic_option` empty at once, each invokes its `f`, and every thread returns the value stored by the first to finish;
+        /// the values produced by the others are discarded. Storing the value has release semantics, and observing it has acquire semantics,
+        /// so the returned value may be dereferenced to see everything written before it was stored.
+        /// If `f` throws, nothing is stored.
+        template<typename F> requires _copyable && std::invocable<F&&> && std::constructible_from<T, std::invoke_result_t<F&&>>
+            T get_or_init(F&& f) noexcept(std::is_nothrow_invocable_v<F&&>){
+                _word w = _m_word.load(std::memory_order_acquire);
+                if(w == _empty_word()){
+                    option<T> val{std::invoke(std::forward<F>(f))};
+                    _word desired = _to_word(val);
+                    if(_m_word.compare_exchange_strong(w, desired, std::memory_order_acq_rel, std::memory_order_acquire))
+                        return *std::move(val);
+                }
+                return *_from_word(w);
+            }
+
+        /// Blocks until the value is no longer `old`, as `std::atomic::wait`. As for `std::atomic`, a change that is undone before this thread observes it may be missed
+        void wait(const option<T>& old, std::memory_order order = std::memory_order_seq_cst) const noexcept{
+            _m_word.wait(_to_word(old), order);
+        }
+
+        void notify_one() noexcept{
+            _m_word.notify_one();
+        }
+
+        void notify_all() noexcept{
+            _m_word.notify_all();
+        }
+    };
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <memory>
+#include <compare>
+
+#include <crabi/option.hxx>
+
+namespace crabi{
+    /// A pointer to `T` that is never null, equivalent to Rust's `NonNull<T>`. Unlike `ref`/`ref_mut` it does not guarantee that the pointee is live.
+    ///
+    /// `option<non_null<T>>` is the same size as `T*`, with `nullptr` representing an empty `option`.
+    /// Note that raw pointers are not niche-optimized, because `nullptr` is a valid value of `T*` (and `Option<*mut T>` in Rust is likewise not niche-optimized).
+    template<typename T> struct non_null{
+    private:
+        T* _m_ptr;
+        constexpr explicit non_null(T* ptr) noexcept : _m_ptr{ptr}{}
+    public:
+        constexpr non_null(T& val) noexcept : _m_ptr{std::addressof(val)}{}
+
+        /// Creates a `non_null` from `ptr`, which must not be null
+        static constexpr non_null new_unchecked(T* ptr) noexcept{
+            return non_null{ptr};
+        }
+
+        /// Creates a `non_null` from `ptr`, or returns an empty `option` if `ptr` is null
+        static constexpr option<non_null> from_ptr(T* ptr) noexcept{
+            if(ptr)
+                return option<non_null>{non_null{ptr}};
+            else
+                return option<non_null>{};
+        }
+
+        template<typename U> requires std::convertible_to<U*, T*>
+            constexpr non_null(non_null<U> other) noexcept : _m_ptr{other.as_ptr()}{}
+
+        constexpr T* as_ptr() const noexcept{
+            return _m_ptr;
+        }
+
+        constexpr T& operator*() const noexcept{
+            return *_m_ptr;
+        }
+
+        constexpr T* operator->() const noexcept{
+            return _m_ptr;
+        }
+
+        constexpr friend bool operator==(const non_null&, const non_null&) noexcept = default;
+        constexpr friend std::compare_three_way_result_t<T*> operator<=>(const non_null&, const non_null&) noexcept = default;
+    };
+
+    template<typename T> struct optional_niche<non_null<T>>{
+        using type = T*;
+        static constexpr T* value = nullptr;
+    };
+}
@@ -7,46 +7,227 @@
 #include <stdexcept>
 #include <functional>
 #include <compare>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <type_traits>
 
 #include <rusty/type_traits.hxx>
 
+#include <crabi/_except.hxx>
+
 namespace crabi{
+    /// A type trait that can be specialized for a scoped enumeration `E` to declare the greatest enumerator of `E`.
+    /// The specialization defines a static data member `value` of type `E`.
+    ///
+    /// When specialized, the underlying values greater than `value` are used as niches for `option<E>`, as for a Rust fieldless enum.
+    /// The behaviour is undefined if an `option<E>` contains a value of `E` which is greater than `value`.
+    template<typename E> requires std::is_scoped_enum_v<E> struct enum_max{};
+
+    namespace _detail{
+        /// The niches provided by the library for types that cannot be named by a partial specialization of `optional_niche`
+        template<typename T> struct _builtin_niche{};
+
+        template<typename E> requires std::is_scoped_enum_v<E> && requires{ { enum_max<E>::value } -> std::convertible_to<E>; }
+            struct _builtin_niche<E>{
+            private:
+                static constexpr auto _max = static_cast<std::underlying_type_t<E>>(enum_max<E>::value);
+            public:
+                using type = std::underlying_type_t<E>;
+                static constexpr type value = _max + 1;
+                static constexpr std::size_t count = static_cast<std::size_t>(std::numeric_limits<type>::max() - _max);
+                static constexpr type nth(std::size_t i) noexcept{
+                    return static_cast<type>(_max + 1 + i);
+                }
+
+                static_assert(_max < std::numeric_limits<type>::max(), "enum_max<E>::value leaves no niche in the underlying type of E");
+            };
+    }
+
     /// @brief A type trait that can be specialized for a type `T` to indicate that it is subject to niche-optimization for `T`
     /// @tparam T The type to niche optimize
     /// 
     /// This trait can be specialized for a type `T` if it satisfies the following conditions:
-    /// * `T` models `std::trivially_copyable`
+    /// * `T` models `std::trivially_copyable`, or `T` is an owning type whose every live object satisfies the last condition below
+    ///   (in which case `option<T>` destroys, copies, and moves the contained value through `T`'s special members)
     /// * The specialization of `optional_niche` defines a member type `type`, which models `std::trivially_copyable` and `std::equality_comparable`
     /// * The specialization of `optional_niche` defines a static data member `value`, which is of the type denoted by `type`,
-    /// * Equality Comparison of `type` is equivalent to equality testing each byte in the value-representation of `type`
+    /// * Two values of `type` with the same value-representation compare equal
     /// * `T` and the member type are the same size
     /// * No constructible value of `T`, when converted to the member `type` via `std::bit_cast` will compare equal to `value`
-    template<typename T> requires std::is_object_v<T> struct optional_niche{};
+    ///
+    /// The specialization may additionally provide more than one niche value by defining:
+    /// * A static data member `count` of type `std::size_t`, which is the number of distinct niche values (at least 1), and
+    /// * A static member function `nth`, such that `nth(i)` returns the `i`th niche value for each `i` less than `count`.
+    ///   `nth(0)` is equal to `value`, and no two niche values compare equal.
+    ///
+    /// The specialization may also define static data members `offset` and `size` of type `std::size_t`, if comparing two values of `type` only inspects the `size` bytes starting at `offset`.
+    /// By default, the niche is all of `T`. A `result` may store its other variant in the bytes of `T` outside of the niche, as Rust does.
+    ///
+    /// If `T` has more than one niche, then `option<T>` is itself niche-optimized, using the remaining niche values.
+    template<typename T> requires std::is_object_v<T> struct optional_niche : _detail::_builtin_niche<T>{};
 
 
     template<typename T> using optional_niche_t = typename optional_niche<T>::type;
     template<typename T> constexpr inline std::same_as<optional_niche_t<T>> auto optional_niche_v =
          optional_niche<T>::value;
 
-
-    
     namespace _detail{
         template<typename T> concept _optional_storage_niche = requires{
             typename optional_niche_t<T>;
         };
+
+        template<typename T> concept _optional_storage_multi_niche = _optional_storage_niche<T> && requires(std::size_t i){
+            { optional_niche<T>::count } -> std::convertible_to<std::size_t>;
+            { optional_niche<T>::nth(i) } -> std::same_as<optional_niche_t<T>>;
+        };
+    }
+
+    /// The number of niche values available for `T`. This is `0` if `T` is not niche-optimized
+    template<typename T> struct optional_niche_count : std::integral_constant<std::size_t, 0>{};
+    template<typename T> requires _detail::_optional_storage_niche<T> struct optional_niche_count<T> : std::integral_constant<std::size_t, 1>{};
+    template<typename T> requires _detail::_optional_storage_multi_niche<T> struct optional_niche_count<T> : std::integral_constant<std::size_t, optional_niche<T>::count>{};
+
+    template<typename T> constexpr inline std::size_t optional_niche_count_v = optional_niche_count<T>::value;
+
+    /// Returns the `i`th niche value of `T`.
+    template<typename T> requires _detail::_optional_storage_niche<T>
+        constexpr optional_niche_t<T> optional_niche_nth(std::size_t i) noexcept{
+            if constexpr(_detail::_optional_storage_multi_niche<T>)
+                return optional_niche<T>::nth(i);
+            else
+                return optional_niche_v<T>;
+        }
+
+    namespace _detail{
+        /// The bytes of `T` that its niche occupies, given by the `offset` and `size` members of `optional_niche<T>`, if it defines them
+        template<typename T> constexpr inline std::size_t _niche_offset_v = 0;
+        template<typename T> requires requires{ { optional_niche<T>::offset } -> std::convertible_to<std::size_t>; }
+            constexpr inline std::size_t _niche_offset_v<T> = optional_niche<T>::offset;
+
+        template<typename T> constexpr inline std::size_t _niche_size_v = sizeof(T);
+        template<typename T> requires requires{ { optional_niche<T>::size } -> std::convertible_to<std::size_t>; }
+            constexpr inline std::size_t _niche_size_v<T> = optional_niche<T>::size;
+    }
+
+    /// `bool` is niche-optimized using the values `2` through `255`, as in Rust
+    template<> struct optional_niche<bool>{
+        using type = unsigned char;
+        static constexpr unsigned char value = 2;
+        static constexpr std::size_t count = 254;
+        static constexpr unsigned char nth(std::size_t i) noexcept{
+            return static_cast<unsigned char>(2 + i);
+        }
+    };
+
+    /// `char32_t` is niche-optimized using the values above `U+10FFFF`, as Rust's `char`.
+    /// Note that this requires every `char32_t` stored in an `option` to be a valid Unicode scalar value
+    template<> struct optional_niche<char32_t>{
+        using type = std::uint32_t;
+        static constexpr std::uint32_t value = 0x110000;
+        static constexpr std::size_t count = 0xFFFFFFFF - 0x10FFFF;
+        static constexpr std::uint32_t nth(std::size_t i) noexcept{
+            return static_cast<std::uint32_t>(0x110000 + i);
+        }
+    };
+
+    namespace _detail{
+        /// The type of the discriminant of a Rust enum whose variants begin with fields of alignment `Align`.
+        /// rustc widens the discriminant to the integer of that alignment, so that it fills the padding before the fields, and reads every byte of it
+        template<std::size_t Align> struct _enum_tag{
+            using type = unsigned char;
+        };
+        template<> struct _enum_tag<2>{
+            using type = std::uint16_t;
+        };
+        template<> struct _enum_tag<4>{
+            using type = std::uint32_t;
+        };
+        template<> struct _enum_tag<8>{
+            using type = std::uint64_t;
+        };
+#ifdef __SIZEOF_INT128__
+        template<> struct _enum_tag<16>{
+            using type = unsigned __int128;
+        };
+#endif
+
+        template<std::size_t Align> using _enum_tag_t = typename _enum_tag<Align>::type;
+
         template<typename T> struct _optional_storage{
         private:
-            struct _storage_none{bool _m_engaged;};
-            struct _storage_some{bool _m_engaged; T _m_val;};
+            // The discriminant is as wide as in `Option<T>`, rather than a `bool` followed by padding that Rust would read as part of it
+            using _tag_t = _enum_tag_t<alignof(T)>;
+            struct _storage_none{_tag_t _m_engaged;};
+            struct _storage_some{_tag_t _m_engaged; T _m_val;};
             union{
-                struct {bool _m_engaged;};
+                struct {_tag_t _m_engaged;};
                 _storage_none _m_none;
                 _storage_some _m_some;
             };
         public:
-            constexpr _optional_storage() noexcept :  _m_none{false}{}
+            constexpr _optional_storage() noexcept :  _m_none{0}{}
+
+            // Each special member is trivial when the corresponding operation on `T` is, so that `option<T>` can be passed and returned in registers.
+            constexpr _optional_storage(const _optional_storage&) noexcept requires std::is_trivially_copy_constructible_v<T> = default;
+            constexpr _optional_storage(const _optional_storage& other) noexcept(std::is_nothrow_copy_constructible_v<T>)
+                requires std::copy_constructible<T> && (!std::is_trivially_copy_constructible_v<T>) : _m_none{0}{
+                    if(other._has_value())
+                        this->_emplace(other._get_value());
+                }
+
+            constexpr _optional_storage(_optional_storage&&) noexcept requires std::is_trivially_move_constructible_v<T> = default;
+            constexpr _optional_storage(_optional_storage&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+                requires std::move_constructible<T> && (!std::is_trivially_move_constructible_v<T>) : _m_none{0}{
+                    if(other._has_value()){
+                        this->_emplace(std::move(other._get_value()));
+                        other._destroy();
+                    }
+                }
+
+            constexpr _optional_storage& operator=(const _optional_storage&) noexcept
+                requires std::is_trivially_copy_constructible_v<T> && std::is_trivially_copy_assignable_v<T> && std::is_trivially_destructible_v<T> = default;
+            constexpr _optional_storage& operator=(const _optional_storage& other) noexcept(std::is_nothrow_copy_constructible_v<T> && std::is_nothrow_copy_assignable_v<T>)
+                requires std::copy_constructible<T> && std::is_copy_assignable_v<T>
+                    && (!(std::is_trivially_copy_constructible_v<T> && std::is_trivially_copy_assignable_v<T> && std::is_trivially_destructible_v<T>)){
+                    if(other._has_value()){
+                        if(this->_has_value())
+                            this->_get_value() = other._get_value();
+                        else
+                            this->_emplace(other._get_value());
+                    }else{
+                        this->_destroy();
+                    }
+                    return *this;
+                }
+
+            constexpr _optional_storage& operator=(_optional_storage&&) noexcept
+                requires std::is_trivially_move_constructible_v<T> && std::is_trivially_move_assignable_v<T> && std::is_trivially_destructible_v<T> = default;
+            constexpr _optional_storage& operator=(_optional_storage&& other) noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>)
+                requires std::move_constructible<T> && std::is_move_assignable_v<T>
+                    && (!(std::is_trivially_move_constructible_v<T> && std::is_trivially_move_assignable_v<T> && std::is_trivially_destructible_v<T>)){
+                    if(other._has_value()){
+                        if(this->_has_value())
+                            this->_get_value() = std::move(other._get_value());
+                        else
+                            this->_emplace(std::move(other._get_value()));
+                        other._destroy();
+                    }else{
+                        this->_destroy();
+                    }
+                    return *this;
+                }
+
+            constexpr ~_optional_storage() noexcept requires std::is_trivially_destructible_v<T> = default;
+            constexpr ~_optional_storage() noexcept{
+                this->_destroy();
+            }
+
             constexpr bool _has_value() const noexcept{
-                return this->_m_engaged;
+                return this->_m_engaged != 0;
             }
 
             constexpr T& _get_value() noexcept{
@@ -59,11 +240,15 @@ namespace crabi{
 
             template<typename... Args> 
                 constexpr void _emplace(Args&&... args) {
-                    ::new(&_m_some) _storage_some{true,T{std::forward<Args>(args)...}};
+                    if consteval{
+                        std::construct_at(std::addressof(_m_some), _storage_some{1,T{std::forward<Args>(args)...}});
+                    }else{
+                        ::new(&_m_some) _storage_some{1,T{std::forward<Args>(args)...}};
+                    }
                 }
 
             constexpr void _destroy() noexcept{
-                if(std::exchange(_m_engaged, false)){
+                if(std::exchange(_m_engaged, _tag_t{0})){
                     _m_some._m_val.~T();
                 }
             }
@@ -92,16 +277,17 @@ namespace crabi{
                 _m_val = nullptr;
             }
 
-            template<typename U> requires std::convertible_to<U(&&)[], T(&&)[]> && (std::is_lvalue_reference_v<T> == std::is_lvalue_reference_v<U>)
-                void _emplace(U&& ref){
-                    _m_val = &ref;
+            template<typename U> requires std::convertible_to<std::remove_reference_t<U>(*)[], std::remove_reference_t<T>(*)[]> 
+                && (std::is_lvalue_reference_v<T> == std::is_lvalue_reference_v<U>)
+                constexpr void _emplace(U&& ref) noexcept{
+                    _m_val = std::addressof(ref);
                 }
 
             template<typename U> requires (std::is_lvalue_reference_v<T> && !std::is_lvalue_reference_v<U>)
                 void _emplace(const U&&) = delete;
         };
 
-        template<typename T> requires (!std::is_reference_v<T> && _optional_storage_niche<T>) struct _optional_storage<T>{
+        template<typename T> requires (!std::is_reference_v<T> && _optional_storage_niche<T> && std::is_trivially_copyable_v<T>) struct _optional_storage<T>{
         private:
             using _storage_type = std::aligned_storage_t<sizeof(T), alignof(T)>;
             union{
@@ -129,11 +315,102 @@ namespace crabi{
             }
 
             template<typename... Args> constexpr void _emplace(Args&&... args){
-                ::new(&_m_storage._m_val) T{std::forward<Args>(args)...};
+                if consteval{
+                    std::construct_at(std::addressof(_m_storage._m_val), T{std::forward<Args>(args)...});
+                }else{
+                    ::new(&_m_storage._m_val) T{std::forward<Args>(args)...};
+                }
             }
 
             constexpr const T* _get_storage() const noexcept{
-                return &this->_m_val;
+                return &this->_m_storage._m_val;
+            }
+        };
+
+        /// Niche storage for owning types (such as `vec`), which must be destroyed, and copied or moved through their own constructors
+        template<typename T> requires (!std::is_reference_v<T> && _optional_storage_niche<T> && !std::is_trivially_copyable_v<T>) struct _optional_storage<T>{
+        private:
+            union _niche_union{
+                optional_niche_t<T> _m_niche_val;
+                T _m_val;
+
+                constexpr _niche_union() noexcept : _m_niche_val{optional_niche_v<T>}{}
+                constexpr ~_niche_union() requires std::is_trivially_destructible_v<T> = default;
+                constexpr ~_niche_union(){}
+            } _m_storage;
+        public:
+            constexpr _optional_storage() noexcept = default;
+
+            constexpr _optional_storage(const _optional_storage& other) noexcept(std::is_nothrow_copy_constructible_v<T>) requires std::copy_constructible<T>{
+                if(other._has_value())
+                    this->_emplace(other._get_value());
+            }
+
+            constexpr _optional_storage(_optional_storage&& other) noexcept(std::is_nothrow_move_constructible_v<T>) requires std::move_constructible<T>{
+                if(other._has_value()){
+                    this->_emplace(std::move(other._get_value()));
+                    other._destroy();
+                }
+            }
+
+            constexpr _optional_storage& operator=(const _optional_storage& other) noexcept(std::is_nothrow_copy_constructible_v<T> && std::is_nothrow_copy_assignable_v<T>)
+                requires std::copy_constructible<T> && std::is_copy_assignable_v<T>{
+                    if(other._has_value()){
+                        if(this->_has_value())
+                            this->_get_value() = other._get_value();
+                        else
+                            this->_emplace(other._get_value());
+                    }else{
+                        this->_destroy();
+                    }
+                    return *this;
+                }
+
+            constexpr _optional_storage& operator=(_optional_storage&& other) noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>)
+                requires std::move_constructible<T> && std::is_move_assignable_v<T>{
+                    if(other._has_value()){
+                        if(this->_has_value())
+                            this->_get_value() = std::move(other._get_value());
+                        else
+                            this->_emplace(std::move(other._get_value()));
+                        other._destroy();
+                    }else{
+                        this->_destroy();
+                    }
+                    return *this;
+                }
+
+            constexpr ~_optional_storage() noexcept{
+                this->_destroy();
+            }
+
+            constexpr bool _has_value() const noexcept{
+                // `T` is not trivially copyable, so the niche is read from the object representation rather than with `std::bit_cast`
+                optional_niche_t<T> val;
+                std::memcpy(std::addressof(val), std::addressof(_m_storage), sizeof(val));
+                return val!=optional_niche_v<T>;
+            }
+
+            constexpr T& _get_value() noexcept{
+                return _m_storage._m_val;
+            }
+            constexpr const T& _get_value() const noexcept{
+                return _m_storage._m_val;
+            }
+
+            constexpr void _destroy() noexcept{
+                if(this->_has_value()){
+                    _m_storage._m_val.~T();
+                    std::construct_at(std::addressof(_m_storage._m_niche_val), optional_niche_v<T>);
+                }
+            }
+
+            template<typename... Args> constexpr void _emplace(Args&&... args){
+                std::construct_at(std::addressof(_m_storage._m_val), std::forward<Args>(args)...);
+            }
+
+            constexpr const T* _get_storage() const noexcept{
+                return &this->_m_storage._m_val;
             }
         };
     }
@@ -155,7 +432,17 @@ namespace crabi{
     };
 
 
+    namespace _detail{
+        /// Satisfied if `T` can be constructed directly from an `option<U>`, in which case `option<T>` wraps the `option<U>` rather than converting the contained value
+        template<typename T, typename U> concept _constructible_from_option = std::constructible_from<T, option<U>&>
+            || std::constructible_from<T, const option<U>&>
+            || std::constructible_from<T, option<U>&&>
+            || std::constructible_from<T, const option<U>&&>;
+    }
+
     template<typename T> struct option : private _detail::_optional_storage<T>{
+    private:
+        template<typename U> friend struct option;
     public:
 
         using value_type = T;
@@ -166,18 +453,18 @@ namespace crabi{
         constexpr option(std::nullopt_t = std::nullopt){}
 
         template<typename U = T> requires std::constructible_from<T, U&&> 
-            && (!rusty::is_specialization_v<std::remove_cvref_t<U>, option>)
+            && (!std::same_as<std::remove_cvref_t<U>, option>)
             && (!rusty::is_specialization_v<std::remove_cvref_t<U>,std::optional>)
             && (!rusty::is_specialization_v<std::remove_cvref_t<U>, some_t>)
             && (!std::same_as<std::remove_cvref_t<U>, std::nullopt_t>)
             && (!std::same_as<std::remove_cvref_t<U>,std::in_place_t>)
             && (!std::same_as<std::remove_cvref_t<U>, none_t>)
-            && (std::is_lvalue_reference_v<T> == std::is_lvalue_reference_v<T>)
+            && (!std::is_lvalue_reference_v<T> || std::is_lvalue_reference_v<U>)
         constexpr explicit(!std::convertible_to<U, T>) option(U&& val) noexcept(std::is_nothrow_constructible_v<T, U&&>) {
             this->_emplace(std::forward<U>(val));
         }
 
-        template<typename U> requires (std::is_lvalue_reference_v<T> != std::is_lvalue_reference_v<T>)
+        template<typename U> requires (std::is_lvalue_reference_v<T> && !std::is_lvalue_reference_v<U>)
             option(const U&&) = delete;
 
         template<typename... Args> requires std::constructible_from<T, Args&&...>&&(!std::is_reference_v<T>)
@@ -194,27 +481,12 @@ namespace crabi{
             option(std::in_place_t, const U&&)=delete;
 
 
-        constexpr option(const option& ) noexcept
-         requires std::copy_constructible<T> && std::is_trivially_copy_constructible_v<T> = default;
-        
-        constexpr option(const option& opt) requires std::copy_constructible<T> && (!std::is_trivially_copy_constructible_v<T>){
-            if (opt._has_value())
-                this->_emplace(*opt);
-        }
-
-        constexpr option(option&&) noexcept 
-            requires std::move_constructible<T> && std::is_trivially_move_constructible_v<T> = default;
-
-        constexpr option(option&& opt) noexcept(std::is_nothrow_move_constructible_v<T>)
-            requires std::move_constructible<T> && (!std::is_trivially_move_constructible_v<T>){
-                if(opt._has_value()){
-                    this->_emplace(std::forward<T>(*opt));
-                    opt._destroy();
-                }
-            }
+        // The copy and move operations are provided by `_optional_storage`, and are trivial whenever the corresponding operation on `T` is
+        constexpr option(const option&) = default;
+        constexpr option(option&&) = default;
 
         template<typename U>
-            requires std::constructible_from<T, const U&>
+            requires std::constructible_from<T, const U&> && (!_detail::_constructible_from_option<T, U>)
             constexpr explicit(!std::convertible_to<const U&,T>)
                 option(const option<U>& val){
                     if(val._has_value()){
@@ -223,11 +495,11 @@ namespace crabi{
                 }
         
         template<typename U>
-            requires std::constructible_from<T,U&&>
+            requires std::constructible_from<T,U&&> && (!_detail::_constructible_from_option<T, U>)
             constexpr explicit(!std::convertible_to<U,T>)
                 option(option<U>&& val) noexcept(std::is_nothrow_constructible_v<T,U&&>){
                     if(val._has_value()){
-                        this->_emplace(std::forward<T>(*val));
+                        this->_emplace(std::move(*val));
                         val._destroy();
                     }
                 }
@@ -249,9 +521,7 @@ namespace crabi{
                     }
                 }
 
-        constexpr ~option() noexcept{
-            this->_destroy();
-        }
+        constexpr ~option() = default;
 
         constexpr bool has_value() const noexcept{
             return this->_has_value();
@@ -271,40 +541,11 @@ namespace crabi{
         
         constexpr option& operator=(std::nullopt_t) noexcept{
             this->_destroy();
+            return *this;
         }
 
-        constexpr option& operator=(const option&) noexcept requires (std::copy_constructible<T> && std::is_copy_assignable_v<T>
-            && std::is_trivially_copy_assignable_v<T>) || std::is_reference_v<T> = default;
-
-        constexpr option& operator=(const option& opt) requires std::copy_constructible<T> && std::is_copy_assignable_v<T>
-            && (!std::is_trivially_copy_assignable_v<T>) && (!std::is_reference_v<T>){
-                if(opt){
-                    if(*this){
-                        this->_get_value() = opt._get_value();
-                    }else{
-                        this->_emplace(opt._get_value());
-                    }
-                }else{
-                    this->_destroy();
-                }
-            }
-
-
-        constexpr option& operator=(option&& ) noexcept requires (std::move_constructible<T> && std::is_move_assignable_v<T>
-            && std::is_trivially_move_assignable_v<T>) || std::is_reference_v<T> = default;
-
-        constexpr option& operator=(option&& opt) noexcept requires std::move_constructible<T> && std::is_move_assignable_v<T>
-            && (!std::is_trivially_move_assignable_v<T>) && (!std::is_reference_v<T>) {
-                if(opt){
-                    if(*this){
-                        this->_get_value() = std::forward<T>(opt._get_value());
-                    }else{
-                        this->_emplace(std::forward<T>(opt._get_value()));
-                    }
-                    opt._destroy();
-                }
-            }
-        
+        constexpr option& operator=(const option&) = default;
+        constexpr option& operator=(option&&) = default;
 
         template<typename... Args> 
             requires std::constructible_from<T,Args&&...> 
@@ -327,7 +568,7 @@ namespace crabi{
                 this->_emplace(std::move(other._get_value()));
                 other._destroy();
             }else if(*this){
-                other._emplace(this->_get_value());
+                other._emplace(std::move(this->_get_value()));
                 this->_destroy();
             }
         }
@@ -354,30 +595,38 @@ namespace crabi{
             return std::forward<T>(this->_get_value());
         }
 
+        constexpr std::remove_reference_t<T>* operator->() noexcept{
+            return std::addressof(this->_get_value());
+        }
+
+        constexpr const std::remove_reference_t<T>* operator->() const noexcept{
+            return std::addressof(this->_get_value());
+        }
+
 
         constexpr T& unwrap() &{
             if(!this->_has_value())
-                throw bad_unwrap{};
+                _CRABI_THROW(bad_unwrap{});
             else
                 return this->_get_value();
         }
 
         constexpr const T& unwrap() const&{
             if(!this->_has_value())
-                throw bad_unwrap{};
+                _CRABI_THROW(bad_unwrap{});
             else
                 return this->_get_value();
         }
         constexpr T&& unwrap() &&{
             if(!this->_has_value())
-                throw bad_unwrap{};
+                _CRABI_THROW(bad_unwrap{});
             else
                 return std::forward<T>(this->_get_value());
         }
 
         constexpr const T&& unwrap() const&&{
             if(!this->_has_value())
-                throw bad_unwrap{};
+                _CRABI_THROW(bad_unwrap{});
             else
                 return std::forward<T>(this->_get_value());
         }
@@ -505,7 +754,7 @@ namespace crabi{
                     return std::nullopt;
             }
 
-        template<typename U> bool operator==(const crabi::option<T>& opt) const requires std::equality_comparable_with<T,U>{
+        template<typename U> constexpr bool operator==(const crabi::option<U>& opt) const requires std::equality_comparable_with<const T&, const U&>{
             if(this->_has_value())
                 return opt._has_value() && this->_get_value() == opt._get_value();
             else
@@ -518,7 +767,7 @@ namespace crabi{
                     case 0: return std::strong_ordering::equivalent;
                     case 1: return std::strong_ordering::less;
                     case 2: return std::strong_ordering::greater;
-                    case 3: return this->_get_value() <=> opt._get_value();
+                    default: return this->_get_value() <=> opt._get_value();
                 }
             }
 
@@ -530,7 +779,7 @@ namespace crabi{
                     case 0: return std::strong_ordering::equivalent;
                     case 1: return std::strong_ordering::less;
                     case 2: return std::strong_ordering::greater;
-                    case 3: return std::strong_order(t._get_value(), u._get_value());
+                    default: return std::strong_order(t._get_value(), u._get_value());
                 }
             }
 
@@ -542,7 +791,7 @@ namespace crabi{
                     case 0: return std::strong_ordering::equivalent;
                     case 1: return std::strong_ordering::less;
                     case 2: return std::strong_ordering::greater;
-                    case 3: return std::weak_order(t._get_value(), u._get_value());
+                    default: return std::weak_order(t._get_value(), u._get_value());
                 }
             }
     };
@@ -601,6 +850,20 @@ namespace crabi{
             }
     };
 
+    /// `option<T>` is niche-optimized whenever `T` has more than one niche value, so that e.g. `option<option<bool>>` is the same size as `bool`.
+    /// The empty `option<T>` keeps the first niche of `T`, and the remaining niches are left for `option<option<T>>`.
+    template<typename T> requires (optional_niche_count_v<T> > 1)
+        struct optional_niche<option<T>>{
+            using type = optional_niche_t<T>;
+            static constexpr type value = optional_niche_nth<T>(1);
+            static constexpr std::size_t count = optional_niche_count_v<T> - 1;
+            static constexpr std::size_t offset = _detail::_niche_offset_v<T>;
+            static constexpr std::size_t size = _detail::_niche_size_v<T>;
+            static constexpr type nth(std::size_t i) noexcept{
+                return optional_niche_nth<T>(i + 1);
+            }
+        };
+
     constexpr inline none_t none;
 
     constexpr inline auto some = [] <typename T> (T&& val) noexcept(std::is_nothrow_constructible_v<T, T&&>) -> some_t<T>{
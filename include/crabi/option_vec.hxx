@@ -0,0 +1,449 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <bit>
+#include <array>
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <concepts>
+#include <type_traits>
+
+#include <rusty/type_traits.hxx>
+#include <crabi/option.hxx>
+
+namespace crabi{
+    namespace _detail{
+        /// The presence bitmap used by `option_vec` and `option_array`. Bit `i%64` of word `i/64` is set if element `i` is engaged.
+        /// Bits past the end of the container are always clear, so whole-word operations never need to mask the last word on read.
+        using _bitmap_word = std::uint64_t;
+
+        constexpr inline std::size_t _bitmap_word_bits = 64;
+
+        constexpr std::size_t _bitmap_words(std::size_t n) noexcept{
+            return (n + _bitmap_word_bits - 1) / _bitmap_word_bits;
+        }
+
+        constexpr _bitmap_word _bitmap_tail_mask(std::size_t n) noexcept{
+            std::size_t rem = n % _bitmap_word_bits;
+            return rem ? (_bitmap_word{1} << rem) - 1 : ~_bitmap_word{0};
+        }
+
+        constexpr bool _bitmap_test(const _bitmap_word* bits, std::size_t i) noexcept{
+            return (bits[i / _bitmap_word_bits] >> (i % _bitmap_word_bits)) & 1;
+        }
+
+        constexpr void _bitmap_set(_bitmap_word* bits, std::size_t i) noexcept{
+            bits[i / _bitmap_word_bits] |= _bitmap_word{1} << (i % _bitmap_word_bits);
+        }
+
+        constexpr void _bitmap_clear(_bitmap_word* bits, std::size_t i) noexcept{
+            bits[i / _bitmap_word_bits] &= ~(_bitmap_word{1} << (i % _bitmap_word_bits));
+        }
+
+        constexpr std::size_t _bitmap_count(const _bitmap_word* bits, std::size_t words) noexcept{
+            std::size_t count = 0;
+            for(std::size_t w = 0; w < words; w++)
+                count += std::popcount(bits[w]);
+            return count;
+        }
+
+        /// Calls `f(i)` for each set bit `i` in `bits`, in increasing order
+        template<typename F> constexpr void _bitmap_for_each(const _bitmap_word* bits, std::size_t words, F&& f){
+            for(std::size_t w = 0; w < words; w++){
+                _bitmap_word word = bits[w];
+                while(word){
+                    std::size_t i = w * _bitmap_word_bits + std::countr_zero(word);
+                    word &= word - 1;
+                    std::invoke(f, i);
+                }
+            }
+        }
+
+        /// Writes the values in `[first, last)` to `out`, substituting `def` for each disengaged element.
+        /// Full and empty words are handled in bulk, so dense or sparse columns run at copy/fill speed.
+        template<typename T, std::output_iterator<const T&> Out>
+            constexpr Out _bitmap_unwrap_or(const _bitmap_word* bits, const T* values, std::size_t first, std::size_t last, const T& def, Out out){
+                std::size_t i = first;
+                while(i < last){
+                    std::size_t w = i / _bitmap_word_bits;
+                    std::size_t off = i % _bitmap_word_bits;
+                    std::size_t len = std::min(_bitmap_word_bits - off, last - i);
+                    _bitmap_word word = bits[w] >> off;
+                    _bitmap_word mask = len == _bitmap_word_bits ? ~_bitmap_word{0} : (_bitmap_word{1} << len) - 1;
+                    word &= mask;
+                    if(word == mask)
+                        out = std::copy_n(values + i, len, out);
+                    else if(!word)
+                        out = std::fill_n(out, len, def);
+                    else
+                        for(std::size_t j = 0; j < len; j++, ++out)
+                            *out = ((word >> j) & 1) ? values[i + j] : def;
+                    i += len;
+                }
+                return out;
+            }
+
+        /// The shared interface of `option_vec` and `option_array`.
+        /// `Derived` provides `_values()`, `_bits()`, and `size()`
+        template<typename Derived, typename T> struct _option_bitmap_base{
+        private:
+            constexpr Derived& _self() noexcept{
+                return static_cast<Derived&>(*this);
+            }
+            constexpr const Derived& _self() const noexcept{
+                return static_cast<const Derived&>(*this);
+            }
+
+            template<typename Container, typename Ref> struct _iterator{
+            private:
+                Container* _m_container;
+                std::size_t _m_idx;
+            public:
+                using value_type = option<Ref>;
+                using reference = option<Ref>;
+                using difference_type = std::ptrdiff_t;
+                using iterator_concept = std::forward_iterator_tag;
+
+                constexpr _iterator() noexcept : _m_container{}, _m_idx{}{}
+                constexpr _iterator(Container* container, std::size_t idx) noexcept : _m_container{container}, _m_idx{idx}{}
+
+                constexpr option<Ref> operator*() const noexcept{
+                    return (*_m_container)[_m_idx];
+                }
+
+                constexpr _iterator& operator++() noexcept{
+                    ++_m_idx;
+                    return *this;
+                }
+
+                constexpr _iterator operator++(int) noexcept{
+                    _iterator tmp{*this};
+                    ++_m_idx;
+                    return tmp;
+                }
+
+                constexpr friend bool operator==(const _iterator& a, const _iterator& b) noexcept{
+                    return a._m_idx == b._m_idx;
+                }
+            };
+        public:
+            using value_type = T;
+            using reference = T&;
+            using const_reference = const T&;
+            using word_type = _bitmap_word;
+            using iterator = _iterator<Derived, T&>;
+            using const_iterator = _iterator<const Derived, const T&>;
+
+            constexpr bool empty() const noexcept{
+                return !_self().size();
+            }
+
+            constexpr bool is_some(std::size_t i) const noexcept{
+                return _bitmap_test(_self()._bits(), i);
+            }
+
+            constexpr bool is_none(std::size_t i) const noexcept{
+                return !this->is_some(i);
+            }
+
+            constexpr option<T&> operator[](std::size_t i) noexcept{
+                if(this->is_some(i))
+                    return option<T&>{_self()._values()[i]};
+                else
+                    return option<T&>{};
+            }
+
+            constexpr option<const T&> operator[](std::size_t i) const noexcept{
+                if(this->is_some(i))
+                    return option<const T&>{_self()._values()[i]};
+                else
+                    return option<const T&>{};
+            }
+
+            constexpr option<T&> get(std::size_t i) noexcept{
+                if(i >= _self().size())
+                    return option<T&>{};
+                return (*this)[i];
+            }
+
+            constexpr option<const T&> get(std::size_t i) const noexcept{
+                if(i >= _self().size())
+                    return option<const T&>{};
+                return (*this)[i];
+            }
+
+            template<typename U> requires std::assignable_from<T&, U&&>
+                constexpr void set(std::size_t i, U&& val) noexcept(std::is_nothrow_assignable_v<T&, U&&>){
+                    _self()._values()[i] = std::forward<U>(val);
+                    _bitmap_set(_self()._bits(), i);
+                }
+
+            /// Makes element `i` disengaged. The stored value is left in place.
+            constexpr void reset(std::size_t i) noexcept{
+                _bitmap_clear(_self()._bits(), i);
+            }
+
+            constexpr void assign(std::size_t i, const option<T>& opt) noexcept(std::is_nothrow_copy_assignable_v<T>){
+                if(opt)
+                    this->set(i, *opt);
+                else
+                    this->reset(i);
+            }
+
+            constexpr std::size_t count_some() const noexcept{
+                return _bitmap_count(_self()._bits(), _bitmap_words(_self().size()));
+            }
+
+            constexpr std::size_t count_none() const noexcept{
+                return _self().size() - this->count_some();
+            }
+
+            /// Makes every element disengaged
+            constexpr void fill_none() noexcept{
+                std::fill_n(_self()._bits(), _bitmap_words(_self().size()), _bitmap_word{0});
+            }
+
+            /// Calls `f(i, val)` for each engaged element, in index order
+            template<typename F> requires std::invocable<F&, std::size_t, T&>
+                constexpr void for_each_some(F&& f){
+                    T* values = _self()._values();
+                    _bitmap_for_each(_self()._bits(), _bitmap_words(_self().size()), [&](std::size_t i){
+                        std::invoke(f, i, values[i]);
+                    });
+                }
+
+            template<typename F> requires std::invocable<F&, std::size_t, const T&>
+                constexpr void for_each_some(F&& f) const{
+                    const T* values = _self()._values();
+                    _bitmap_for_each(_self()._bits(), _bitmap_words(_self().size()), [&](std::size_t i){
+                        std::invoke(f, i, values[i]);
+                    });
+                }
+
+            /// Writes each value in `[first, last)` to `out`, or `def` for disengaged elements, and returns the end of the output range
+            template<std::output_iterator<const T&> Out>
+                constexpr Out unwrap_or(std::size_t first, std::size_t last, const T& def, Out out) const{
+                    return _bitmap_unwrap_or(_self()._bits(), _self()._values(), first, last, def, std::move(out));
+                }
+
+            template<std::output_iterator<const T&> Out>
+                constexpr Out unwrap_or(const T& def, Out out) const{
+                    return this->unwrap_or(0, _self().size(), def, std::move(out));
+                }
+
+            /// The densely packed values. Values of disengaged elements are unspecified
+            constexpr T* values() noexcept{
+                return _self()._values();
+            }
+
+            constexpr const T* values() const noexcept{
+                return _self()._values();
+            }
+
+            /// The presence bitmap: bit `i%64` of word `i/64` is set if element `i` is engaged
+            constexpr const word_type* bitmap() const noexcept{
+                return _self()._bits();
+            }
+
+            constexpr iterator begin() noexcept{
+                return iterator{&_self(), 0};
+            }
+
+            constexpr const_iterator begin() const noexcept{
+                return const_iterator{&_self(), 0};
+            }
+
+            constexpr const_iterator cbegin() const noexcept{
+                return this->begin();
+            }
+
+            constexpr iterator end() noexcept{
+                return iterator{&_self(), _self().size()};
+            }
+
+            constexpr const_iterator end() const noexcept{
+                return const_iterator{&_self(), _self().size()};
+            }
+
+            constexpr const_iterator cend() const noexcept{
+                return this->end();
+            }
+        };
+    }
+
+    /// A fixed-size sequence of `N` optional values of type `T`, stored as a dense array of `T` and a separate presence bitmap.
+    /// Elements are accessed as `option<T&>`/`option<const T&>`
+    template<typename T, std::size_t N> requires std::is_trivially_copyable_v<T> && std::default_initializable<T>
+        struct option_array : _detail::_option_bitmap_base<option_array<T,N>, T>{
+        private:
+            friend struct _detail::_option_bitmap_base<option_array<T,N>, T>;
+            std::array<T, N> _m_values{};
+            std::array<_detail::_bitmap_word, _detail::_bitmap_words(N)> _m_bits{};
+
+            constexpr T* _values() noexcept{
+                return _m_values.data();
+            }
+            constexpr const T* _values() const noexcept{
+                return _m_values.data();
+            }
+            constexpr _detail::_bitmap_word* _bits() noexcept{
+                return _m_bits.data();
+            }
+            constexpr const _detail::_bitmap_word* _bits() const noexcept{
+                return _m_bits.data();
+            }
+        public:
+            constexpr option_array() noexcept = default;
+
+            constexpr std::size_t size() const noexcept{
+                return N;
+            }
+        };
+
+    /// A growable sequence of optional values of type `T`, stored as a dense vector of `T` and a separate presence bitmap.
+    /// Elements are accessed as `option<T&>`/`option<const T&>`
+    template<typename T, typename Alloc = std::allocator<T>> requires std::is_trivially_copyable_v<T> && std::default_initializable<T>
+        struct option_vec : _detail::_option_bitmap_base<option_vec<T, Alloc>, T>{
+        private:
+            friend struct _detail::_option_bitmap_base<option_vec<T, Alloc>, T>;
+            using _word_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<_detail::_bitmap_word>;
+            std::vector<T, Alloc> _m_values;
+            std::vector<_detail::_bitmap_word, _word_alloc> _m_bits;
+
+            constexpr T* _values() noexcept{
+                return _m_values.data();
+            }
+            constexpr const T* _values() const noexcept{
+                return _m_values.data();
+            }
+            constexpr _detail::_bitmap_word* _bits() noexcept{
+                return _m_bits.data();
+            }
+            constexpr const _detail::_bitmap_word* _bits() const noexcept{
+                return _m_bits.data();
+            }
+        public:
+            using allocator_type = Alloc;
+            using word_type = _detail::_bitmap_word;
+
+            constexpr option_vec() noexcept(noexcept(Alloc())) = default;
+
+            constexpr explicit option_vec(const Alloc& alloc) noexcept : _m_values(alloc), _m_bits(_word_alloc(alloc)){}
+
+            /// Creates an `option_vec` with `n` disengaged elements
+            constexpr explicit option_vec(std::size_t n, const Alloc& alloc = Alloc()) :
+                _m_values(n, alloc), _m_bits(_detail::_bitmap_words(n), _word_alloc(alloc)){}
+
+            constexpr std::size_t size() const noexcept{
+                return _m_values.size();
+            }
+
+            constexpr std::size_t capacity() const noexcept{
+                return _m_values.capacity();
+            }
+
+            constexpr void reserve(std::size_t n){
+                _m_values.reserve(n);
+                _m_bits.reserve(_detail::_bitmap_words(n));
+            }
+
+            constexpr void clear() noexcept{
+                _m_values.clear();
+                _m_bits.clear();
+            }
+
+            /// Resizes to `n` elements. New elements are disengaged
+            constexpr void resize(std::size_t n){
+                std::size_t words = _detail::_bitmap_words(n);
+                _m_values.resize(n);
+                _m_bits.resize(words);
+                if(words)
+                    _m_bits[words - 1] &= _detail::_bitmap_tail_mask(n);
+            }
+
+            template<typename... Args> requires std::constructible_from<T, Args&&...>
+                constexpr T& emplace_back(Args&&... args){
+                    std::size_t i = this->size();
+                    if(i % _detail::_bitmap_word_bits == 0)
+                        _m_bits.push_back(0);
+                    T& val = _m_values.emplace_back(std::forward<Args>(args)...);
+                    _detail::_bitmap_set(_m_bits.data(), i);
+                    return val;
+                }
+
+            constexpr void push_back(const T& val){
+                this->emplace_back(val);
+            }
+
+            constexpr void push_back(const option<T>& opt){
+                if(opt)
+                    this->emplace_back(*opt);
+                else
+                    this->push_none();
+            }
+
+            constexpr void push_none(){
+                if(this->size() % _detail::_bitmap_word_bits == 0)
+                    _m_bits.push_back(0);
+                _m_values.emplace_back();
+            }
+
+            /// Appends `n` elements, copying the values from `values` and presence from `bitmap` (in the format returned by `bitmap()`).
+            /// When the current size is a multiple of 64, the bitmap is copied word-wise.
+            /// The source may be the storage of `*this` (as in `v.append(v.values(), v.bitmap(), v.size())`), in which case it is copied before `*this` grows
+            constexpr void append(const T* values, const word_type* bitmap, std::size_t n){
+                if(this->_aliases(values, bitmap)){
+                    option_vec tmp(this->get_allocator());
+                    tmp._append(values, bitmap, n);
+                    this->_append(tmp._values(), tmp._bits(), n);
+                }else{
+                    this->_append(values, bitmap, n);
+                }
+            }
+
+            constexpr allocator_type get_allocator() const noexcept{
+                return _m_values.get_allocator();
+            }
+        private:
+            /// Whether `values` or `bitmap` points into the storage of `*this`, which `resize` may free
+            constexpr bool _aliases(const T* values, const word_type* bitmap) const noexcept{
+                // Pointers to unrelated objects cannot be compared during constant evaluation, so the source is always copied
+                if consteval{
+                    return true;
+                }
+                auto within = [](const auto* p, const auto* first, std::size_t len){
+                    return !std::less<>{}(p, first) && std::less<>{}(p, first + len);
+                };
+                return within(values, _m_values.data(), _m_values.size()) || within(bitmap, _m_bits.data(), _m_bits.size());
+            }
+
+            /// The values are copied without first being value-initialized, and the bitmap is copied (or shifted into place) a word at a time
+            constexpr void _append(const T* values, const word_type* bitmap, std::size_t n){
+                std::size_t old = this->size();
+                std::size_t words = _detail::_bitmap_words(n);
+                _m_values.insert(_m_values.end(), values, values + n);
+                _m_bits.resize(_detail::_bitmap_words(old + n));
+                _detail::_bitmap_word* dst = _m_bits.data() + old / _detail::_bitmap_word_bits;
+                std::size_t shift = old % _detail::_bitmap_word_bits;
+                if(shift == 0){
+                    std::copy_n(bitmap, words, dst);
+                }else{
+                    // Each source word straddles two destination words. The words after `dst[0]` were added by `resize`, so are clear
+                    std::size_t dst_words = _m_bits.size() - old / _detail::_bitmap_word_bits;
+                    for(std::size_t w = 0; w < words; w++){
+                        _detail::_bitmap_word word = w == words - 1 ? bitmap[w] & _detail::_bitmap_tail_mask(n) : bitmap[w];
+                        dst[w] |= word << shift;
+                        if(w + 1 < dst_words)
+                            dst[w + 1] |= word >> (_detail::_bitmap_word_bits - shift);
+                    }
+                }
+                if(words)
+                    _m_bits.back() &= _detail::_bitmap_tail_mask(old + n);
+            }
+        };
+}
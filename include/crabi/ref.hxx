@@ -1,3 +1,7 @@
+#pragma once
+
+#include <memory>
+
 #include <crabi/option.hxx>
 #include <rusty/type_traits.hxx>
 #include <rusty/concepts.hxx>
@@ -7,8 +11,8 @@ namespace crabi{
     private:
         const T* _m_inner;
     public:
-        ref_mut(const T& val) : _m_inner(&val){}
-        ref_mut(const T&&) = delete;
+        constexpr ref(const T& val) noexcept : _m_inner(std::addressof(val)){}
+        ref(const T&&) = delete;
 
         const T& operator*() const noexcept{
             return *_m_inner;
@@ -28,11 +32,12 @@ namespace crabi{
     private:
         T* _m_inner;
     public:
-        ref_mut(T& val) : _m_inner{&val}{}
+        constexpr ref_mut(T& val) noexcept : _m_inner{std::addressof(val)}{}
         ref_mut(const T&) = delete;
-        ref_mut(T&&) noexcept = default;
-        ref_mut& operator=(const T&) = delete;
-        ref_mut& operator=(T&&) noexcept = default;
+        ref_mut(const ref_mut&) = delete;
+        constexpr ref_mut(ref_mut&&) noexcept = default;
+        ref_mut& operator=(const ref_mut&) = delete;
+        constexpr ref_mut& operator=(ref_mut&&) noexcept = default;
         
 
         T& operator*() noexcept{
@@ -51,8 +56,8 @@ namespace crabi{
             return _m_inner;
         }
 
-        operator ref<T>() const noexcept{
-            return ref{*_m_inner};
+        constexpr operator ref<T>() const noexcept{
+            return ref<T>{*_m_inner};
         }
 
         template<typename Idx>
@@ -71,11 +76,11 @@ namespace crabi{
 
     template<typename T> struct optional_niche<ref<T>>{
         using type = const T*;
-        constexpr inline const T* value = nullptr;
+        static constexpr const T* value = nullptr;
     };
 
     template<typename T> struct optional_niche<ref_mut<T>>{
         using type = T*;
-        constexpr inline T* value = nullptr;
+        static constexpr T* value = nullptr;
     };
 }
@@ -0,0 +1,769 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+#include <rusty/type_traits.hxx>
+
+#include <crabi/option.hxx>
+#include <crabi/_except.hxx>
+
+namespace crabi{
+    template<typename T, typename E> struct result;
+
+    template<typename T> struct ok_t;
+
+    template<typename E> struct err_t;
+
+    struct bad_result_unwrap : std::exception{
+    private:
+        template<typename T, typename E> friend struct result;
+        bool _m_on_ok;
+        explicit bad_result_unwrap(bool on_ok) noexcept : _m_on_ok{on_ok}{}
+    public:
+        const char* what() const noexcept override{
+            if(_m_on_ok)
+                return "Attempt to call unwrap_err on an `ok` value";
+            else
+                return "Attempt to call unwrap on an `err` value";
+        }
+    };
+
+    /// The error returned by the `checked_at` accessors of `array` and `slice`: the index, and the length of the sequence it was out of bounds for.
+    /// Unlike the `std::out_of_range` thrown by `at`, producing an `index_error` never allocates or formats a message
+    struct index_error{
+        std::size_t p_index;
+        std::size_t p_len;
+
+        constexpr friend bool operator==(const index_error&, const index_error&) noexcept = default;
+    };
+
+    namespace _detail{
+        /// A reference held by a `result`. As for `option<T&>`, it is never null
+        template<typename T> struct _result_ref{
+            T* _m_ptr;
+
+            constexpr _result_ref(T& ref) noexcept : _m_ptr{std::addressof(ref)}{}
+        };
+
+        template<typename T> using _result_slot_t = std::conditional_t<std::is_reference_v<T>, _result_ref<std::remove_reference_t<T>>, T>;
+
+        /// Types that occupy no storage in a variant of a Rust enum, such as `()`.
+        /// A `result` with a unit variant uses the niche of the other variant, if it has one
+        template<typename T> concept _result_unit = std::is_empty_v<T> && std::is_trivially_copyable_v<T> && std::is_trivially_default_constructible_v<T>;
+
+        constexpr std::size_t _align_up(std::size_t n, std::size_t align) noexcept{
+            return (n + align - 1) / align * align;
+        }
+
+        /// The niche representation of a `result` with a tag of type `Tag`, which uses the tag values `2` through `255`. Only the tag is inspected
+        template<std::size_t N, typename Tag> struct _result_tag_niche{
+            Tag _m_tag;
+            unsigned char _m_rest[N - sizeof(Tag)]{};
+
+            constexpr friend bool operator==(const _result_tag_niche& a, const _result_tag_niche& b) noexcept{
+                return a._m_tag == b._m_tag;
+            }
+        };
+
+        template<std::size_t N, typename Tag> requires (N == sizeof(Tag)) struct _result_tag_niche<N, Tag>{
+            Tag _m_tag;
+
+            constexpr friend bool operator==(const _result_tag_niche& a, const _result_tag_niche& b) noexcept{
+                return a._m_tag == b._m_tag;
+            }
+        };
+
+        /// The alignment that a field of type `T` contributes to the width of an enum discriminant. rustc ignores zero-sized fields with alignment 1 (such as `()`)
+        template<typename T> constexpr inline std::size_t _enum_field_align = std::is_empty_v<T> && alignof(T) == 1 ? 0 : alignof(T);
+
+        template<typename T, typename E> constexpr inline std::size_t _result_tag_align =
+            !_enum_field_align<T> ? (!_enum_field_align<E> ? 1 : _enum_field_align<E>)
+            : !_enum_field_align<E> ? _enum_field_align<T>
+            : _enum_field_align<T> < _enum_field_align<E> ? _enum_field_align<T> : _enum_field_align<E>;
+
+        /// The tagged representation of `result`, as Rust lays out `Result<T, E>` when neither variant can be stored in a niche of the other.
+        /// The tag is at offset 0 (`0` for `ok`, `1` for `err`), and each payload follows the tag at its own alignment.
+        /// As in Rust, the tag is an integer as wide as the lesser alignment of `T` and `E`, which fills the padding before the payload
+        template<typename T, typename E> struct _result_storage{
+        private:
+            using _tag_t = _enum_tag_t<_result_tag_align<T, E>>;
+            struct _storage_ok{_tag_t _m_is_err; [[no_unique_address]] T _m_val;};
+            struct _storage_err{_tag_t _m_is_err; [[no_unique_address]] E _m_val;};
+            union{
+                struct {_tag_t _m_is_err;};
+                _storage_ok _m_ok;
+                _storage_err _m_err;
+            };
+
+            static constexpr bool _trivially_copy_constructible = std::is_trivially_copy_constructible_v<T> && std::is_trivially_copy_constructible_v<E>;
+            static constexpr bool _trivially_move_constructible = std::is_trivially_move_constructible_v<T> && std::is_trivially_move_constructible_v<E>;
+            static constexpr bool _trivially_destructible = std::is_trivially_destructible_v<T> && std::is_trivially_destructible_v<E>;
+            static constexpr bool _trivially_copy_assignable = _trivially_copy_constructible && _trivially_destructible
+                && std::is_trivially_copy_assignable_v<T> && std::is_trivially_copy_assignable_v<E>;
+            static constexpr bool _trivially_move_assignable = _trivially_move_constructible && _trivially_destructible
+                && std::is_trivially_move_assignable_v<T> && std::is_trivially_move_assignable_v<E>;
+        public:
+            // The size of the union, which is padded to the alignment of the more aligned variant even if that variant is the smaller one
+            using _niche_type = _result_tag_niche<_align_up(sizeof(_storage_ok) < sizeof(_storage_err) ? sizeof(_storage_err) : sizeof(_storage_ok),
+                alignof(_storage_ok) < alignof(_storage_err) ? alignof(_storage_err) : alignof(_storage_ok)), _tag_t>;
+            static constexpr std::size_t _niche_count = 254;
+            static constexpr std::size_t _niche_offset = 0;
+            static constexpr std::size_t _niche_size = sizeof(_tag_t);
+            static constexpr _niche_type _niche_nth(std::size_t i) noexcept{
+                return _niche_type{static_cast<_tag_t>(2 + i)};
+            }
+
+            template<typename... Args> constexpr explicit _result_storage(std::in_place_index_t<0>, Args&&... args){
+                this->template _emplace<0>(std::forward<Args>(args)...);
+            }
+
+            template<typename... Args> constexpr explicit _result_storage(std::in_place_index_t<1>, Args&&... args){
+                this->template _emplace<1>(std::forward<Args>(args)...);
+            }
+
+            // As for `option`, each special member is trivial when the corresponding operations on `T` and `E` are
+            constexpr _result_storage(const _result_storage&) noexcept requires _trivially_copy_constructible = default;
+            constexpr _result_storage(const _result_storage& other) noexcept(std::is_nothrow_copy_constructible_v<T> && std::is_nothrow_copy_constructible_v<E>)
+                requires std::copy_constructible<T> && std::copy_constructible<E> && (!_trivially_copy_constructible){
+                    if(other._is_err())
+                        this->template _emplace<1>(other._m_err._m_val);
+                    else
+                        this->template _emplace<0>(other._m_ok._m_val);
+                }
+
+            constexpr _result_storage(_result_storage&&) noexcept requires _trivially_move_constructible = default;
+            constexpr _result_storage(_result_storage&& other) noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_constructible_v<E>)
+                requires std::move_constructible<T> && std::move_constructible<E> && (!_trivially_move_constructible){
+                    if(other._is_err())
+                        this->template _emplace<1>(std::move(other._m_err._m_val));
+                    else
+                        this->template _emplace<0>(std::move(other._m_ok._m_val));
+                }
+
+            // When the variants differ, the new value is copied before the old one is destroyed, so that a throwing copy leaves `*this` unchanged
+            constexpr _result_storage& operator=(const _result_storage&) noexcept requires _trivially_copy_assignable = default;
+            constexpr _result_storage& operator=(const _result_storage& other)
+                requires std::copy_constructible<T> && std::copy_constructible<E> && std::is_copy_assignable_v<T> && std::is_copy_assignable_v<E>
+                    && std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_constructible_v<E> && (!_trivially_copy_assignable){
+                    if(this->_is_err() == other._is_err()){
+                        if(other._is_err())
+                            _m_err._m_val = other._m_err._m_val;
+                        else
+                            _m_ok._m_val = other._m_ok._m_val;
+                    }else if(other._is_err()){
+                        E tmp(other._m_err._m_val);
+                        this->_destroy();
+                        this->template _emplace<1>(std::move(tmp));
+                    }else{
+                        T tmp(other._m_ok._m_val);
+                        this->_destroy();
+                        this->template _emplace<0>(std::move(tmp));
+                    }
+                    return *this;
+                }
+
+            constexpr _result_storage& operator=(_result_storage&&) noexcept requires _trivially_move_assignable = default;
+            constexpr _result_storage& operator=(_result_storage&& other) noexcept(std::is_nothrow_move_assignable_v<T> && std::is_nothrow_move_assignable_v<E>)
+                requires std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_constructible_v<E> && std::is_move_assignable_v<T> && std::is_move_assignable_v<E>
+                    && (!_trivially_move_assignable){
+                    if(this->_is_err() == other._is_err()){
+                        if(other._is_err())
+                            _m_err._m_val = std::move(other._m_err._m_val);
+                        else
+                            _m_ok._m_val = std::move(other._m_ok._m_val);
+                    }else{
+                        this->_destroy();
+                        if(other._is_err())
+                            this->template _emplace<1>(std::move(other._m_err._m_val));
+                        else
+                            this->template _emplace<0>(std::move(other._m_ok._m_val));
+                    }
+                    return *this;
+                }
+
+            constexpr ~_result_storage() noexcept requires _trivially_destructible = default;
+            constexpr ~_result_storage() noexcept{
+                this->_destroy();
+            }
+
+            constexpr bool _is_err() const noexcept{
+                return this->_m_is_err != 0;
+            }
+
+            template<std::size_t I> constexpr auto& _get() noexcept{
+                if constexpr(I == 0)
+                    return _m_ok._m_val;
+                else
+                    return _m_err._m_val;
+            }
+
+            template<std::size_t I> constexpr const auto& _get() const noexcept{
+                if constexpr(I == 0)
+                    return _m_ok._m_val;
+                else
+                    return _m_err._m_val;
+            }
+
+            /// Constructs the variant `I`. The previous variant, if any, must have been destroyed
+            template<std::size_t I, typename... Args> constexpr void _emplace(Args&&... args){
+                if constexpr(I == 0)
+                    std::construct_at(std::addressof(_m_ok), _storage_ok{0, T(std::forward<Args>(args)...)});
+                else
+                    std::construct_at(std::addressof(_m_err), _storage_err{1, E(std::forward<Args>(args)...)});
+            }
+
+            constexpr void _destroy() noexcept{
+                if(this->_is_err())
+                    _m_err._m_val.~E();
+                else
+                    _m_ok._m_val.~T();
+            }
+        };
+
+        /// The niche representation of `result`, when the variant `1 - I` is a unit type and the variant `I` (of type `D`) has a niche, as Rust lays out `Result<&T, ()>` or `Result<(), NonNull<T>>`.
+        /// The payload of variant `I` is held in an `option`-like storage, whose empty state represents the unit variant
+        template<typename D, typename U, std::size_t I> struct _result_niche_storage{
+        private:
+            _optional_storage<D> _m_data;
+            [[no_unique_address]] U _m_unit;
+        public:
+            using _niche_type = optional_niche_t<D>;
+            static constexpr std::size_t _niche_count = optional_niche_count_v<D> - 1;
+            static constexpr std::size_t _niche_offset = _niche_offset_v<D>;
+            static constexpr std::size_t _niche_size = _niche_size_v<D>;
+            static constexpr _niche_type _niche_nth(std::size_t i) noexcept{
+                return optional_niche_nth<D>(i + 1);
+            }
+
+            template<typename... Args> constexpr explicit _result_niche_storage(std::in_place_index_t<I>, Args&&... args) : _m_data{}, _m_unit{}{
+                _m_data._emplace(std::forward<Args>(args)...);
+            }
+
+            template<typename... Args> constexpr explicit _result_niche_storage(std::in_place_index_t<1 - I>, Args&&... args) : _m_data{}, _m_unit(std::forward<Args>(args)...){}
+
+            constexpr bool _is_err() const noexcept{
+                return _m_data._has_value() == (I == 1);
+            }
+
+            template<std::size_t J> constexpr auto& _get() noexcept{
+                if constexpr(J == I)
+                    return _m_data._get_value();
+                else
+                    return _m_unit;
+            }
+
+            template<std::size_t J> constexpr const auto& _get() const noexcept{
+                if constexpr(J == I)
+                    return _m_data._get_value();
+                else
+                    return _m_unit;
+            }
+
+            template<std::size_t J, typename... Args> constexpr void _emplace(Args&&... args){
+                if constexpr(J == I)
+                    _m_data._emplace(std::forward<Args>(args)...);
+                else
+                    _m_unit = U(std::forward<Args>(args)...);
+            }
+
+            constexpr void _destroy() noexcept{
+                _m_data._destroy();
+            }
+        };
+
+        /// The niche-filling layout of `result`, in which the variant of type `U` is stored in the bytes of `D` that are not part of the niche of `D`:
+        /// before the niche if it fits there, and otherwise after the niche, at the alignment of `U`. This is the placement rustc tries for an enum with a niche
+        template<typename D, typename U> struct _result_fill_layout{
+            static constexpr std::size_t align = alignof(D) < alignof(U) ? alignof(U) : alignof(D);
+            static constexpr std::size_t size = _align_up(sizeof(D), align);
+            static constexpr std::size_t offset = sizeof(U) <= _niche_offset_v<D> ? 0 : _align_up(_niche_offset_v<D> + _niche_size_v<D>, alignof(U));
+            static constexpr bool fits = offset + sizeof(U) <= size;
+        };
+
+        /// The niche-filling representation of `result`, when the variant `I` (of type `D`) has a niche, and the other variant (of type `U`) fits beside it,
+        /// as Rust lays out `Result<&[u8], u64>`. The first niche of `D` represents the variant `1 - I`, whose value is stored at `_layout::offset`.
+        /// Both `D` and `U` are trivially copyable, so the storage is an array of bytes
+        template<typename D, typename U, std::size_t I> struct _result_niche_fill_storage{
+        private:
+            using _layout = _result_fill_layout<D, U>;
+            alignas(_layout::align) unsigned char _m_bytes[_layout::size];
+
+            D* _data() noexcept{
+                return std::launder(reinterpret_cast<D*>(_m_bytes));
+            }
+            const D* _data() const noexcept{
+                return std::launder(reinterpret_cast<const D*>(_m_bytes));
+            }
+            U* _other() noexcept{
+                return std::launder(reinterpret_cast<U*>(_m_bytes + _layout::offset));
+            }
+            const U* _other() const noexcept{
+                return std::launder(reinterpret_cast<const U*>(_m_bytes + _layout::offset));
+            }
+        public:
+            using _niche_type = optional_niche_t<D>;
+            // The remaining niches are only usable when they cover the whole `result`, which is larger than `D` if `U` has the greater alignment
+            static constexpr std::size_t _niche_count = _layout::size == sizeof(D) ? optional_niche_count_v<D> - 1 : 0;
+            static constexpr std::size_t _niche_offset = _niche_offset_v<D>;
+            static constexpr std::size_t _niche_size = _niche_size_v<D>;
+            static constexpr _niche_type _niche_nth(std::size_t i) noexcept{
+                return optional_niche_nth<D>(i + 1);
+            }
+
+            template<typename... Args> explicit _result_niche_fill_storage(std::in_place_index_t<I>, Args&&... args){
+                this->template _emplace<I>(std::forward<Args>(args)...);
+            }
+
+            template<typename... Args> explicit _result_niche_fill_storage(std::in_place_index_t<1 - I>, Args&&... args){
+                this->template _emplace<1 - I>(std::forward<Args>(args)...);
+            }
+
+            bool _is_err() const noexcept{
+                // Only the bytes of the niche are compared, so the value of `U` is never mistaken for part of `D`
+                _niche_type val;
+                std::memcpy(std::addressof(val), _m_bytes, sizeof(val));
+                return (val == optional_niche_nth<D>(0)) == (I == 0);
+            }
+
+            template<std::size_t J> auto& _get() noexcept{
+                if constexpr(J == I)
+                    return *this->_data();
+                else
+                    return *this->_other();
+            }
+
+            template<std::size_t J> const auto& _get() const noexcept{
+                if constexpr(J == I)
+                    return *this->_data();
+                else
+                    return *this->_other();
+            }
+
+            template<std::size_t J, typename... Args> void _emplace(Args&&... args){
+                if constexpr(J == I)
+                    ::new(static_cast<void*>(_m_bytes)) D(std::forward<Args>(args)...);
+                else{
+                    ::new(static_cast<void*>(_m_bytes + _layout::offset)) U(std::forward<Args>(args)...);
+                    // Only the niche is written, which may follow the value of `U`
+                    constexpr _niche_type niche = optional_niche_nth<D>(0);
+                    std::memcpy(_m_bytes + _niche_offset, reinterpret_cast<const unsigned char*>(std::addressof(niche)) + _niche_offset, _niche_size);
+                }
+            }
+
+            constexpr void _destroy() noexcept{}
+        };
+
+        /// Whether `result<T, E>` uses the niche of its variant `I` (of type `D`) to store its other variant (of type `U`), instead of a tag.
+        /// As rustc does, this is chosen if it is smaller than the tagged representation, or the same size and leaves more niches (rustc counts every unused tag value, which is all but 2)
+        template<typename T, typename E, typename D, typename U> constexpr inline bool _result_use_fill = [] {
+            if constexpr(!(std::is_trivially_copyable_v<D> && std::is_trivially_copyable_v<U> && _result_fill_layout<D, U>::fits))
+                return false;
+            else{
+                using _tag_t = _enum_tag_t<_result_tag_align<T, E>>;
+                constexpr std::size_t tagged_size = sizeof(_result_storage<T, E>);
+                constexpr std::size_t tagged_niches = sizeof(_tag_t) < sizeof(std::size_t) ? (std::size_t{1} << (8 * sizeof(_tag_t))) - 2 : std::size_t(-2);
+                constexpr std::size_t size = _result_fill_layout<D, U>::size;
+                return size < tagged_size || (size == tagged_size && optional_niche_count_v<D> - 1 > tagged_niches);
+            }
+        }();
+
+        template<typename T, typename E> struct _result_storage_select{
+            using type = _result_storage<T, E>;
+        };
+
+        // Otherwise, rustc uses the niche of the variant with the most niche values (of `E`, if they have as many), if the other variant fits beside it
+        template<typename T, typename E> requires (!_result_unit<T>) && (!_result_unit<E>) && _optional_storage_niche<E>
+            && (optional_niche_count_v<E> >= optional_niche_count_v<T>) && _result_use_fill<T, E, E, T>
+            struct _result_storage_select<T, E>{
+                using type = _result_niche_fill_storage<E, T, 1>;
+            };
+
+        template<typename T, typename E> requires (!_result_unit<T>) && (!_result_unit<E>) && _optional_storage_niche<T>
+            && (optional_niche_count_v<T> > optional_niche_count_v<E>) && _result_use_fill<T, E, T, E>
+            struct _result_storage_select<T, E>{
+                using type = _result_niche_fill_storage<T, E, 0>;
+            };
+
+        template<typename T, typename E> requires _optional_storage_niche<T> && _result_unit<E>
+            struct _result_storage_select<T, E>{
+                using type = _result_niche_storage<T, E, 0>;
+            };
+
+        template<typename T, typename E> requires _optional_storage_niche<E> && _result_unit<T> && (!(_optional_storage_niche<T> && _result_unit<E>))
+            struct _result_storage_select<T, E>{
+                using type = _result_niche_storage<E, T, 1>;
+            };
+
+        template<typename T, typename E> using _result_storage_t = typename _result_storage_select<_result_slot_t<T>, _result_slot_t<E>>::type;
+
+        template<typename T> constexpr inline bool _is_in_place_index = false;
+        template<std::size_t I> constexpr inline bool _is_in_place_index<std::in_place_index_t<I>> = true;
+    }
+
+    template<typename T> struct optional_niche<_detail::_result_ref<T>>{
+        using type = std::uintptr_t;
+        static constexpr std::uintptr_t value = 0;
+    };
+
+    /// A value of type `T`, or an error of type `E`, equivalent to Rust's `Result<T, E>`.
+    ///
+    /// `result<T, E>` has the same layout as `Result<T, E>`:
+    /// * If `E` is an empty type and `T` has a niche (see `optional_niche`), `err` is represented by the first niche of `T`, and `result<T, E>` is the same size as `T` (and conversely with `T` and `E` swapped).
+    /// * Otherwise, if one of `T` and `E` has a niche, and the other fits in its bytes before or after the niche (as `u64` does after the data pointer of `&[u8]`), the other variant is stored there,
+    ///   and represented by the first niche, if that is smaller than the tagged layout. This requires both `T` and `E` to be trivially copyable.
+    /// * Otherwise, `result<T, E>` begins with a tag, which is `0` for `ok` and `1` for `err`, followed by the payload at its alignment.
+    ///
+    /// In either case, `option<result<T, E>>` uses the remaining niches, and is the same size as `result<T, E>` if there are any.
+    /// Either of `T` or `E` may be an lvalue reference, which is represented as a non-null pointer.
+    ///
+    /// A `result` never throws except from `unwrap` and `unwrap_err`, so it can be used to report errors with `-fno-exceptions`.
+    template<typename T, typename E> struct result : private _detail::_result_storage_t<T, E>{
+    private:
+        static_assert(!std::is_rvalue_reference_v<T> && !std::is_rvalue_reference_v<E>, "result does not support rvalue references");
+        static_assert(!std::is_void_v<T> && !std::is_void_v<E>, "result<void, E> is not supported: use an empty type instead, which occupies no space");
+
+        using _base = _detail::_result_storage_t<T, E>;
+
+        template<typename U, typename F> friend struct result;
+
+        template<std::size_t I, typename Self> static constexpr decltype(auto) _value(Self& self) noexcept{
+            using V = std::conditional_t<I == 0, T, E>;
+            if constexpr(std::is_reference_v<V>)
+                return static_cast<V>(*self.template _get<I>()._m_ptr);
+            else
+                return self.template _get<I>();
+        }
+    public:
+        using value_type = T;
+        using error_type = E;
+
+        template<typename U = T> requires std::constructible_from<T, U&&>
+            && (!std::same_as<std::remove_cvref_t<U>, result>)
+            && (!rusty::is_specialization_v<std::remove_cvref_t<U>, ok_t>)
+            && (!rusty::is_specialization_v<std::remove_cvref_t<U>, err_t>)
+            && (!_detail::_is_in_place_index<std::remove_cvref_t<U>>)
+            && (!std::is_lvalue_reference_v<T> || std::is_lvalue_reference_v<U>)
+        constexpr explicit(!std::convertible_to<U, T>) result(U&& val) noexcept(std::is_nothrow_constructible_v<T, U&&>) : _base{std::in_place_index<0>, std::forward<U>(val)}{}
+
+        template<typename... Args> requires std::constructible_from<T, Args&&...>
+            constexpr explicit result(std::in_place_index_t<0>, Args&&... args) : _base{std::in_place_index<0>, std::forward<Args>(args)...}{}
+
+        template<typename... Args> requires std::constructible_from<E, Args&&...>
+            constexpr explicit result(std::in_place_index_t<1>, Args&&... args) : _base{std::in_place_index<1>, std::forward<Args>(args)...}{}
+
+        template<typename U> requires std::constructible_from<T, U&&> && (!std::is_lvalue_reference_v<T> || std::is_lvalue_reference_v<U>)
+            constexpr result(ok_t<U>&& val) noexcept(std::is_nothrow_constructible_v<T, U&&>) : _base{std::in_place_index<0>, std::forward<U>(val._m_val)}{}
+
+        template<typename U> requires std::constructible_from<E, U&&> && (!std::is_lvalue_reference_v<E> || std::is_lvalue_reference_v<U>)
+            constexpr result(err_t<U>&& val) noexcept(std::is_nothrow_constructible_v<E, U&&>) : _base{std::in_place_index<1>, std::forward<U>(val._m_val)}{}
+
+        // The copy and move operations are provided by the storage, and are trivial whenever the corresponding operations on `T` and `E` are
+        constexpr result(const result&) = default;
+        constexpr result(result&&) = default;
+        constexpr result& operator=(const result&) = default;
+        constexpr result& operator=(result&&) = default;
+        constexpr ~result() = default;
+
+        constexpr bool is_ok() const noexcept{
+            return !this->_is_err();
+        }
+
+        constexpr bool is_err() const noexcept{
+            return this->_is_err();
+        }
+
+        constexpr explicit operator bool() const noexcept{
+            return !this->_is_err();
+        }
+
+        /// Accesses the `ok` value.
+        /// *Preconditions*: `is_ok()`
+        constexpr T& operator*() & noexcept{
+            return _value<0>(*this);
+        }
+
+        constexpr const T& operator*() const& noexcept{
+            return _value<0>(*this);
+        }
+
+        constexpr T&& operator*() && noexcept{
+            return std::forward<T>(_value<0>(*this));
+        }
+
+        constexpr const T&& operator*() const&& noexcept{
+            return std::forward<const T>(_value<0>(*this));
+        }
+
+        constexpr std::remove_reference_t<T>* operator->() noexcept{
+            return std::addressof(_value<0>(*this));
+        }
+
+        constexpr const std::remove_reference_t<T>* operator->() const noexcept{
+            return std::addressof(_value<0>(*this));
+        }
+
+        /// Accesses the `err` value.
+        /// *Preconditions*: `is_err()`
+        constexpr E& error() & noexcept{
+            return _value<1>(*this);
+        }
+
+        constexpr const E& error() const& noexcept{
+            return _value<1>(*this);
+        }
+
+        constexpr E&& error() && noexcept{
+            return std::forward<E>(_value<1>(*this));
+        }
+
+        constexpr T& unwrap() &{
+            if(this->_is_err()) [[unlikely]]
+                _CRABI_THROW(bad_result_unwrap{false});
+            return _value<0>(*this);
+        }
+
+        constexpr const T& unwrap() const&{
+            if(this->_is_err()) [[unlikely]]
+                _CRABI_THROW(bad_result_unwrap{false});
+            return _value<0>(*this);
+        }
+
+        constexpr T&& unwrap() &&{
+            if(this->_is_err()) [[unlikely]]
+                _CRABI_THROW(bad_result_unwrap{false});
+            return std::forward<T>(_value<0>(*this));
+        }
+
+        constexpr E& unwrap_err() &{
+            if(!this->_is_err()) [[unlikely]]
+                _CRABI_THROW(bad_result_unwrap{true});
+            return _value<1>(*this);
+        }
+
+        constexpr const E& unwrap_err() const&{
+            if(!this->_is_err()) [[unlikely]]
+                _CRABI_THROW(bad_result_unwrap{true});
+            return _value<1>(*this);
+        }
+
+        constexpr E&& unwrap_err() &&{
+            if(!this->_is_err()) [[unlikely]]
+                _CRABI_THROW(bad_result_unwrap{true});
+            return std::forward<E>(_value<1>(*this));
+        }
+
+        template<typename U> requires std::constructible_from<T, U&&> && std::copy_constructible<T>
+            constexpr T unwrap_or(U&& val) const&{
+                if(this->_is_err())
+                    return T(std::forward<U>(val));
+                else
+                    return _value<0>(*this);
+            }
+
+        template<typename U> requires std::constructible_from<T, U&&> && std::move_constructible<T>
+            constexpr T unwrap_or(U&& val) && noexcept(std::is_nothrow_constructible_v<T, U&&> && std::is_nothrow_move_constructible_v<T>){
+                if(this->_is_err())
+                    return T(std::forward<U>(val));
+                else
+                    return std::forward<T>(_value<0>(*this));
+            }
+
+        /// Returns the `ok` value, or the result of invoking `f` with the error
+        template<typename F> requires std::invocable<F&&, const E&> && std::convertible_to<std::invoke_result_t<F&&, const E&>, T> && std::copy_constructible<T>
+            constexpr T unwrap_or_else(F&& f) const&{
+                if(this->_is_err())
+                    return std::invoke(std::forward<F>(f), _value<1>(*this));
+                else
+                    return _value<0>(*this);
+            }
+
+        template<typename F> requires std::invocable<F&&, E&&> && std::convertible_to<std::invoke_result_t<F&&, E&&>, T> && std::move_constructible<T>
+            constexpr T unwrap_or_else(F&& f) &&{
+                if(this->_is_err())
+                    return std::invoke(std::forward<F>(f), std::forward<E>(_value<1>(*this)));
+                else
+                    return std::forward<T>(_value<0>(*this));
+            }
+
+        /// Converts into an `option` of the `ok` value, discarding the error
+        constexpr option<T> ok() const& requires std::copy_constructible<T>{
+            if(this->_is_err())
+                return option<T>{};
+            else
+                return option<T>{std::in_place, _value<0>(*this)};
+        }
+
+        constexpr option<T> ok() && requires std::move_constructible<T>{
+            if(this->_is_err())
+                return option<T>{};
+            else
+                return option<T>{std::in_place, std::forward<T>(_value<0>(*this))};
+        }
+
+        /// Converts into an `option` of the error, discarding the `ok` value
+        constexpr option<E> err() const& requires std::copy_constructible<E>{
+            if(this->_is_err())
+                return option<E>{std::in_place, _value<1>(*this)};
+            else
+                return option<E>{};
+        }
+
+        constexpr option<E> err() && requires std::move_constructible<E>{
+            if(this->_is_err())
+                return option<E>{std::in_place, std::forward<E>(_value<1>(*this))};
+            else
+                return option<E>{};
+        }
+
+        constexpr result<T&, E&> as_ref() & noexcept{
+            if(this->_is_err())
+                return result<T&, E&>{std::in_place_index<1>, _value<1>(*this)};
+            else
+                return result<T&, E&>{std::in_place_index<0>, _value<0>(*this)};
+        }
+
+        constexpr result<const T&, const E&> as_ref() const& noexcept{
+            if(this->_is_err())
+                return result<const T&, const E&>{std::in_place_index<1>, _value<1>(*this)};
+            else
+                return result<const T&, const E&>{std::in_place_index<0>, _value<0>(*this)};
+        }
+
+        template<typename F> requires std::invocable<F&&, const T&> && std::copy_constructible<E>
+            constexpr result<std::invoke_result_t<F&&, const T&>, E> map(F&& f) const&{
+                using R = result<std::invoke_result_t<F&&, const T&>, E>;
+                if(this->_is_err())
+                    return R{std::in_place_index<1>, _value<1>(*this)};
+                else
+                    return R{std::in_place_index<0>, std::invoke(std::forward<F>(f), _value<0>(*this))};
+            }
+
+        template<typename F> requires std::invocable<F&&, T&&> && std::move_constructible<E>
+            constexpr result<std::invoke_result_t<F&&, T&&>, E> map(F&& f) &&{
+                using R = result<std::invoke_result_t<F&&, T&&>, E>;
+                if(this->_is_err())
+                    return R{std::in_place_index<1>, std::forward<E>(_value<1>(*this))};
+                else
+                    return R{std::in_place_index<0>, std::invoke(std::forward<F>(f), std::forward<T>(_value<0>(*this)))};
+            }
+
+        template<typename F> requires std::invocable<F&&, const E&> && std::copy_constructible<T>
+            constexpr result<T, std::invoke_result_t<F&&, const E&>> map_err(F&& f) const&{
+                using R = result<T, std::invoke_result_t<F&&, const E&>>;
+                if(this->_is_err())
+                    return R{std::in_place_index<1>, std::invoke(std::forward<F>(f), _value<1>(*this))};
+                else
+                    return R{std::in_place_index<0>, _value<0>(*this)};
+            }
+
+        template<typename F> requires std::invocable<F&&, E&&> && std::move_constructible<T>
+            constexpr result<T, std::invoke_result_t<F&&, E&&>> map_err(F&& f) &&{
+                using R = result<T, std::invoke_result_t<F&&, E&&>>;
+                if(this->_is_err())
+                    return R{std::in_place_index<1>, std::invoke(std::forward<F>(f), std::forward<E>(_value<1>(*this)))};
+                else
+                    return R{std::in_place_index<0>, std::forward<T>(_value<0>(*this))};
+            }
+
+        /// Invokes `f` with the `ok` value, which returns a `result` with the same error type, or propagates the error
+        template<typename F> requires std::invocable<F&&, const T&> && rusty::is_specialization_v<std::invoke_result_t<F&&, const T&>, result>
+            && std::same_as<typename std::invoke_result_t<F&&, const T&>::error_type, E>
+            constexpr std::invoke_result_t<F&&, const T&> and_then(F&& f) const&{
+                if(this->_is_err())
+                    return std::invoke_result_t<F&&, const T&>{std::in_place_index<1>, _value<1>(*this)};
+                else
+                    return std::invoke(std::forward<F>(f), _value<0>(*this));
+            }
+
+        template<typename F> requires std::invocable<F&&, T&&> && rusty::is_specialization_v<std::invoke_result_t<F&&, T&&>, result>
+            && std::same_as<typename std::invoke_result_t<F&&, T&&>::error_type, E>
+            constexpr std::invoke_result_t<F&&, T&&> and_then(F&& f) &&{
+                if(this->_is_err())
+                    return std::invoke_result_t<F&&, T&&>{std::in_place_index<1>, std::forward<E>(_value<1>(*this))};
+                else
+                    return std::invoke(std::forward<F>(f), std::forward<T>(_value<0>(*this)));
+            }
+
+        /// Invokes `f` with the error, which returns a `result` with the same value type, or propagates the `ok` value
+        template<typename F> requires std::invocable<F&&, const E&> && rusty::is_specialization_v<std::invoke_result_t<F&&, const E&>, result>
+            && std::same_as<typename std::invoke_result_t<F&&, const E&>::value_type, T>
+            constexpr std::invoke_result_t<F&&, const E&> or_else(F&& f) const&{
+                if(this->_is_err())
+                    return std::invoke(std::forward<F>(f), _value<1>(*this));
+                else
+                    return std::invoke_result_t<F&&, const E&>{std::in_place_index<0>, _value<0>(*this)};
+            }
+
+        template<typename F> requires std::invocable<F&&, E&&> && rusty::is_specialization_v<std::invoke_result_t<F&&, E&&>, result>
+            && std::same_as<typename std::invoke_result_t<F&&, E&&>::value_type, T>
+            constexpr std::invoke_result_t<F&&, E&&> or_else(F&& f) &&{
+                if(this->_is_err())
+                    return std::invoke(std::forward<F>(f), std::forward<E>(_value<1>(*this)));
+                else
+                    return std::invoke_result_t<F&&, E&&>{std::in_place_index<0>, std::forward<T>(_value<0>(*this))};
+            }
+
+        template<typename U, typename F> requires std::equality_comparable_with<const T&, const U&> && std::equality_comparable_with<const E&, const F&>
+            constexpr bool operator==(const result<U, F>& other) const{
+                if(this->_is_err() != other._is_err())
+                    return false;
+                else if(this->_is_err())
+                    return _value<1>(*this) == result<U, F>::template _value<1>(other);
+                else
+                    return _value<0>(*this) == result<U, F>::template _value<0>(other);
+            }
+
+        template<typename U> requires std::equality_comparable_with<const T&, const U&>
+            constexpr bool operator==(const ok_t<U>& other) const{
+                return !this->_is_err() && _value<0>(*this) == other._m_val;
+            }
+
+        template<typename U> requires std::equality_comparable_with<const E&, const U&>
+            constexpr bool operator==(const err_t<U>& other) const{
+                return this->_is_err() && _value<1>(*this) == other._m_val;
+            }
+    };
+
+    /// An `ok` value which converts to any `result<T, E>` that `T` can be constructed from, as Rust's `Ok(val)`
+    template<typename T> struct ok_t{
+        T _m_val;
+    };
+
+    /// An error which converts to any `result<T, E>` that `E` can be constructed from, as Rust's `Err(val)`
+    template<typename E> struct err_t{
+        E _m_val;
+    };
+
+    template<typename T, typename E> requires (_detail::_result_storage_t<T, E>::_niche_count > 0)
+        struct optional_niche<result<T, E>>{
+        private:
+            using _storage = _detail::_result_storage_t<T, E>;
+        public:
+            using type = typename _storage::_niche_type;
+            static_assert(sizeof(type) == sizeof(result<T, E>), "the niche representation of result must be as large as result");
+            static constexpr type value = _storage::_niche_nth(0);
+            static constexpr std::size_t count = _storage::_niche_count;
+            static constexpr std::size_t offset = _storage::_niche_offset;
+            static constexpr std::size_t size = _storage::_niche_size;
+            static constexpr type nth(std::size_t i) noexcept{
+                return _storage::_niche_nth(i);
+            }
+        };
+
+    constexpr inline auto ok = [] <typename T> (T&& val) noexcept(std::is_nothrow_constructible_v<T, T&&>) -> ok_t<T>{
+        return ok_t<T>{std::forward<T>(val)};
+    };
+
+    constexpr inline auto err = [] <typename E> (E&& val) noexcept(std::is_nothrow_constructible_v<E, E&&>) -> err_t<E>{
+        return err_t<E>{std::forward<E>(val)};
+    };
+}
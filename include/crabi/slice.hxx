@@ -6,77 +6,136 @@
 #include <utility>
 #include <stdexcept>
 #include <span>
+#include <array>
+#include <memory>
+#include <cstring>
+#include <algorithm>
 
 #include <rusty/type_traits.hxx>
 #include <rusty/concepts.hxx>
 #include <crabi/option.hxx>
+#include <crabi/result.hxx>
+#include <crabi/array.hxx>
+#include <crabi/_simd.hxx>
 #include <ranges>
 #include <exception>
 #include <format>
+#include <string_view>
 
 namespace crabi{
     namespace slice{
-        
+
         template<typename T> struct raw_slice_ptr{
             T* p_data;
             std::size_t p_len;
 
         };
 
+        namespace _detail{
+            /// Static storage for a single (never constructed) `T`, used as the data pointer of empty slices.
+            /// Like Rust, the data pointer of a `slice` is never null, so that null can be used as the niche of `option<slice<T>>`
+            template<typename T> union _empty_slice_storage{
+                unsigned char _m_dummy;
+                T _m_val;
+                constexpr _empty_slice_storage() noexcept : _m_dummy{}{}
+                constexpr ~_empty_slice_storage() requires std::is_trivially_destructible_v<T> = default;
+                constexpr ~_empty_slice_storage(){}
+            };
+
+            template<typename T> constinit inline _empty_slice_storage<std::remove_cv_t<T>> _empty_slice{};
+
+            template<typename T> constexpr T* _dangling() noexcept{
+                return std::addressof(_empty_slice<T>._m_val);
+            }
+
+            template<typename T> constexpr T* _non_null(T* ptr) noexcept{
+                return ptr ? ptr : _dangling<T>();
+            }
+
+            template<typename T> struct _is_array : std::false_type{};
+            template<typename T, std::size_t N> struct _is_array<array<T,N>> : std::true_type{};
+
+            template<typename T> concept _bitwise_equality = std::is_trivially_copyable_v<T> && std::has_unique_object_representations_v<T>
+                && std::equality_comparable<T> && std::is_scalar_v<T>;
+        }
+
+        template<typename T> struct slice;
+
+        template<typename T> struct chunks;
+        template<typename T> struct chunks_exact;
+        template<typename T> struct windows;
+
         template<typename T> struct slice{
         private:
             raw_slice_ptr<T> _m_ptr;
+
+            static constexpr void _check_split(std::size_t mid, std::size_t len){
+                using namespace std::string_view_literals;
+                if (mid > len) [[unlikely]]
+                    _CRABI_THROW(std::out_of_range{std::format("Index {} out of bounds for slice with length {}"sv, mid, len)});
+            }
         public:
-            using value_type = T;
+            using element_type = T;
+            using value_type = std::remove_cv_t<T>;
             using reference = T&;
             using const_reference = const T&;
             using iterator = T*;
             using const_iterator = const T*;
+            using reverse_iterator = std::reverse_iterator<T*>;
+            using const_reverse_iterator = std::reverse_iterator<const T*>;
 
 
-            template<std::ranges::contiguous_range Range> requires std::convertible_to<std::remove_reference_t<std::ranges::range_reference_t<Range>>(&)[], T(&)[]>
-                constexpr slice(Range&& c) : raw_slice_ptr{std::ranges::data(c), std::ranges::size(c)}{}
+            template<std::ranges::contiguous_range Range> requires std::ranges::sized_range<Range>
+                && std::convertible_to<std::remove_reference_t<std::ranges::range_reference_t<Range>>(*)[], T(*)[]>
+                && (std::ranges::borrowed_range<Range> || std::is_const_v<T>)
+                && (!rusty::is_specialization_v<std::remove_cvref_t<Range>, slice>)
+                && (!_detail::_is_array<std::remove_cvref_t<Range>>::value)
+                && (!std::is_array_v<std::remove_cvref_t<Range>>)
+                constexpr slice(Range&& c) noexcept : _m_ptr{_detail::_non_null<T>(std::ranges::data(c)), std::ranges::size(c)}{}
 
             template<std::contiguous_iterator Iter, std::sized_sentinel_for<Iter> Sentinel>
-                requires std::convertible_to<std::remove_reference_t<std::iter_reference_t<Iter>>(&)[], T(&)[]>
-                constexpr slice(Iter begin, Sentinel end) : 
-                    raw_slice_ptr{std::addressof(*begin), std::ranges::distance(begin, end)}{}
+                requires std::convertible_to<std::remove_reference_t<std::iter_reference_t<Iter>>(*)[], T(*)[]> && (!std::convertible_to<Sentinel, std::size_t>)
+                constexpr slice(Iter begin, Sentinel end) noexcept :
+                    _m_ptr{_detail::_non_null<T>(std::to_address(begin)), static_cast<std::size_t>(end - begin)}{}
 
             template<std::contiguous_iterator Iter>
-                requires std::convertible_to<std::remove_reference_t<std::iter_reference_t<Iter>>(&)[], T(&)[]>
-                constepxr slice(Iter begin, std::size_t len) noexcept : raw_slice_ptr{std::addressof(*begin), len}{}
+                requires std::convertible_to<std::remove_reference_t<std::iter_reference_t<Iter>>(*)[], T(*)[]>
+                constexpr slice(Iter begin, std::size_t len) noexcept : _m_ptr{_detail::_non_null<T>(std::to_address(begin)), len}{}
 
             template<typename U,std::size_t N>
-                requires std::convertible_to<U(&)[], T(&)[]>
-                constexpr slice(U (&array)[N]) noexcept : raw_slice_ptr{array, N}{}
+                requires std::convertible_to<U(*)[], T(*)[]>
+                constexpr slice(U (&array)[N]) noexcept : _m_ptr{array, N}{}
 
             template<typename U, std::size_t N>
-                requires std::convertible_to<U(&)[], T(&)[]>
-                constexpr slice(array<U,N>& arr) noexcept : raw_slice_ptr{arr.data(), N}{}
+                requires std::convertible_to<U(*)[], T(*)[]>
+                constexpr slice(array<U,N>& arr) noexcept : _m_ptr{_detail::_non_null<T>(arr.data()), N}{}
             template<typename U, std::size_t N>
-                requires std::convertible_to<const U(&)[], T(&)[]>
-                constexpr slice(const array<U,N>& arr) noexcept : raw_slice_ptr{arr.data(), N}{}
-
-            template<typename U, std::size_t N>
-                requires std::convertible_to<U(&)[], T(&)[]>
-                constexpr slice(std::array<U,N>& arr) noexcept : raw_slice_ptr{arr.data(), N}{}
-            template<typename U, std::size_t N>
-                requires std::convertible_to<const U(&)[], T(&)[]>
-                constexpr slice(const std::array<U,N>& arr) noexcept : raw_slice_ptr{arr.data(), N}{}
+                requires std::convertible_to<const U(*)[], T(*)[]>
+                constexpr slice(const array<U,N>& arr) noexcept : _m_ptr{_detail::_non_null<T>(arr.data()), N}{}
 
             template<typename U>
-                requires std::convertible_to<U(&)[], T(&)[]>
-                constexpr slice(slice<U> sl) noexcept : raw_slice_ptr{sl.data(), sl.size()}{}
+                requires std::convertible_to<U(*)[], T(*)[]> && (!std::same_as<U, T>)
+                constexpr slice(slice<U> sl) noexcept : _m_ptr{sl.data(), sl.size()}{}
 
             template<typename U, std::size_t Ex>
-                requires std::convertible_to<U(&)[], T(&)[]>
-                constexpr slice(std::span<U,Ex>)
+                requires std::convertible_to<U(*)[], T(*)[]>
+                constexpr slice(std::span<U,Ex> sp) noexcept : _m_ptr{_detail::_non_null<T>(sp.data()), sp.size()}{}
 
             constexpr slice(const slice& sl) noexcept = default;
             constexpr slice(slice&& sl) noexcept = default;
+            constexpr slice& operator=(const slice& sl) noexcept = default;
+            constexpr slice& operator=(slice&& sl) noexcept = default;
 
-            // This const cast is valid because we never modify the (zero sized) range
-            constexpr slice() noexcept : slice(const_cast<array<T,0>&>(_empty_array)){}
+            constexpr slice() noexcept : _m_ptr{_detail::_dangling<T>(), 0}{}
+
+            /// Creates a `slice` from the raw parts. `ptr` must not be null, and must point to `len` live objects of type `T`
+            static constexpr slice from_raw_parts(T* ptr, std::size_t len) noexcept{
+                return slice{ptr, len};
+            }
+
+            constexpr raw_slice_ptr<T> as_raw() const noexcept{
+                return _m_ptr;
+            }
 
             constexpr T* data() const noexcept{
                 return _m_ptr.p_data;
@@ -89,11 +148,330 @@ namespace crabi{
             constexpr std::size_t size() const noexcept{
                 return _m_ptr.p_len;
             }
+
+            constexpr bool empty() const noexcept{
+                return !_m_ptr.p_len;
+            }
+
+            constexpr std::span<T> as_span() const noexcept{
+                return std::span<T>{this->data(), this->size()};
+            }
+
+            constexpr iterator begin() const noexcept{
+                return this->data();
+            }
+
+            constexpr const_iterator cbegin() const noexcept{
+                return this->data();
+            }
+
+            constexpr iterator end() const noexcept{
+                return this->data() + this->size();
+            }
+
+            constexpr const_iterator cend() const noexcept{
+                return this->data() + this->size();
+            }
+
+            constexpr reverse_iterator rbegin() const noexcept{
+                return reverse_iterator{this->end()};
+            }
+            constexpr const_reverse_iterator crbegin() const noexcept{
+                return const_reverse_iterator{this->cend()};
+            }
+            constexpr reverse_iterator rend() const noexcept{
+                return reverse_iterator{this->begin()};
+            }
+            constexpr const_reverse_iterator crend() const noexcept{
+                return const_reverse_iterator{this->cbegin()};
+            }
+
+            constexpr reference operator[](std::size_t i) const noexcept{
+                return this->data()[i];
+            }
+
+            constexpr crabi::option<reference> get(std::size_t i) const noexcept{
+                if (i >= this->size())
+                    return crabi::option<reference>{};
+                else
+                    return crabi::option<reference>{this->data()[i]};
+            }
+
+            /// Returns the element at `i`, or an empty `option` if `i` is out of bounds. Equivalent to `get`
+            constexpr crabi::option<reference> try_get(std::size_t i) const noexcept{
+                return this->get(i);
+            }
+
+            /// Returns the element at `i`, or an `index_error` if `i` is out of bounds
+            constexpr crabi::result<reference, crabi::index_error> checked_at(std::size_t i) const noexcept{
+                if (i >= this->size()) [[unlikely]]
+                    return crabi::err(crabi::index_error{i, this->size()});
+                return this->data()[i];
+            }
+
+            constexpr crabi::option<reference> first() const noexcept{
+                return this->get(0);
+            }
+
+            constexpr crabi::option<reference> last() const noexcept{
+                if (this->empty())
+                    return crabi::option<reference>{};
+                else
+                    return crabi::option<reference>{this->data()[this->size() - 1]};
+            }
+
+            /// Returns the slice `[first, first+len)` of `*this`.
+            /// *Preconditions*: `first + len <= size()`
+            constexpr slice subslice(std::size_t first, std::size_t len) const noexcept{
+                return slice{this->data() + first, len};
+            }
+
+            /// Divides the slice into `[0, mid)` and `[mid, size())`.
+            /// Throws `std::out_of_range` if `mid > size()`
+            constexpr std::pair<slice, slice> split_at(std::size_t mid) const{
+                _check_split(mid, this->size());
+                return {slice{this->data(), mid}, slice{this->data() + mid, this->size() - mid}};
+            }
+
+            /// Returns a view of the non-overlapping subslices of `n` elements, the last of which may be shorter.
+            /// Throws `std::invalid_argument` if `n` is `0`
+            constexpr crabi::slice::chunks<T> chunks(std::size_t n) const{
+                return crabi::slice::chunks<T>{*this, n};
+            }
+
+            /// Returns a view of the non-overlapping subslices of exactly `n` elements. The elements that do not fit are available from `remainder()` on the view.
+            /// Throws `std::invalid_argument` if `n` is `0`
+            constexpr crabi::slice::chunks_exact<T> chunks_exact(std::size_t n) const{
+                return crabi::slice::chunks_exact<T>{*this, n};
+            }
+
+            /// Returns a view of each overlapping subslice of `n` elements.
+            /// Throws `std::invalid_argument` if `n` is `0`
+            constexpr crabi::slice::windows<T> windows(std::size_t n) const{
+                return crabi::slice::windows<T>{*this, n};
+            }
+
+            /// Returns the index of the first element equal to `val`, if any.
+            /// Vectorized for integer, enumeration, and pointer element types
+            template<typename U> requires std::equality_comparable_with<const T&, const U&>
+                constexpr crabi::option<std::size_t> position(const U& val) const noexcept(noexcept(std::declval<const T&>() == val)){
+                    if constexpr(crabi::_detail::_simd_scalar<value_type> && std::same_as<value_type, U>){
+                        if !consteval{
+                            std::size_t idx = crabi::_detail::_simd_find<value_type>(this->data(), this->size(), val);
+                            if (idx == this->size())
+                                return crabi::option<std::size_t>{};
+                            else
+                                return crabi::option<std::size_t>{idx};
+                        }
+                    }
+                    for(std::size_t i = 0; i < this->size(); i++)
+                        if (this->data()[i] == val)
+                            return crabi::option<std::size_t>{i};
+                    return crabi::option<std::size_t>{};
+                }
+
+            template<typename U> requires std::equality_comparable_with<const T&, const U&>
+                constexpr bool contains(const U& val) const noexcept(noexcept(std::declval<const T&>() == val)){
+                    return this->position(val).has_value();
+                }
+
+            template<typename U> requires std::equality_comparable_with<const T&, const U&>
+                constexpr bool starts_with(slice<U> prefix) const noexcept(noexcept(std::declval<const T&>() == std::declval<const U&>())){
+                    return prefix.size() <= this->size() && this->subslice(0, prefix.size()) == prefix;
+                }
+
+            template<typename U> requires std::equality_comparable_with<const T&, const U&>
+                constexpr bool ends_with(slice<U> suffix) const noexcept(noexcept(std::declval<const T&>() == std::declval<const U&>())){
+                    return suffix.size() <= this->size() && this->subslice(this->size() - suffix.size(), suffix.size()) == suffix;
+                }
+
+            /// Copies the elements of `src` into `*this`. `src` must not overlap `*this`.
+            /// Throws `std::out_of_range` if `src.size() != size()`
+            template<typename U> requires (!std::is_const_v<T>) && std::is_assignable_v<T&, const U&>
+                constexpr void copy_from_slice(slice<U> src) const{
+                    using namespace std::string_view_literals;
+                    if (src.size() != this->size()) [[unlikely]]
+                        _CRABI_THROW(std::out_of_range{std::format("Source slice length ({}) does not match destination slice length ({})"sv, src.size(), this->size())});
+                    if constexpr(std::is_trivially_copyable_v<T> && std::same_as<value_type, std::remove_cv_t<U>>){
+                        if !consteval{
+                            // libc's memcpy is already vectorized for the target, and the slices cannot overlap
+                            std::memcpy(this->data(), src.data(), this->size() * sizeof(T));
+                            return;
+                        }
+                    }
+                    std::copy_n(src.data(), src.size(), this->data());
+                }
+
+            template<typename U> requires std::equality_comparable_with<const T&, const U&>
+                constexpr friend bool operator==(const slice& a, const slice<U>& b) noexcept(noexcept(std::declval<const T&>() == std::declval<const U&>())){
+                    if (a.size() != b.size())
+                        return false;
+                    if constexpr(_detail::_bitwise_equality<value_type> && std::same_as<value_type, std::remove_cv_t<U>>){
+                        if !consteval{
+                            // libc's memcmp is vectorized for the target (selected at runtime), so it is used directly
+                            return !a.size() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+                        }
+                    }
+                    return std::equal(a.begin(), a.end(), b.begin());
+                }
+        };
+
+        template<typename T> slice(T*, std::size_t) -> slice<T>;
+        template<typename T, std::size_t N> slice(T (&)[N]) -> slice<T>;
+        template<typename T, std::size_t N> slice(array<T,N>&) -> slice<T>;
+        template<typename T, std::size_t N> slice(const array<T,N>&) -> slice<const T>;
+        template<typename T, std::size_t Ex> slice(std::span<T, Ex>) -> slice<T>;
+        template<std::ranges::contiguous_range Range> slice(Range&&) -> slice<std::remove_reference_t<std::ranges::range_reference_t<Range>>>;
+
+        /// The iterator of the `chunks`, `chunks_exact`, and `windows` views, which yields subslices of up to `size` elements whose starts are `step` elements apart
+        template<typename T> struct _subslice_iterator{
+        private:
+            T* _m_pos;
+            std::size_t _m_remaining;
+            std::size_t _m_size;
+            std::size_t _m_step;
+        public:
+            using value_type = slice<T>;
+            using difference_type = std::ptrdiff_t;
+            using iterator_concept = std::forward_iterator_tag;
+
+            constexpr _subslice_iterator() noexcept : _m_pos{}, _m_remaining{}, _m_size{}, _m_step{1}{}
+            constexpr _subslice_iterator(T* pos, std::size_t remaining, std::size_t size, std::size_t step) noexcept :
+                _m_pos{pos}, _m_remaining{remaining}, _m_size{size}, _m_step{step}{}
+
+            constexpr slice<T> operator*() const noexcept{
+                return slice<T>{_m_pos, std::min(_m_size, _m_remaining)};
+            }
+
+            constexpr _subslice_iterator& operator++() noexcept{
+                std::size_t step = std::min(_m_step, _m_remaining);
+                _m_pos += step;
+                _m_remaining -= step;
+                return *this;
+            }
+
+            constexpr _subslice_iterator operator++(int) noexcept{
+                _subslice_iterator tmp{*this};
+                ++*this;
+                return tmp;
+            }
+
+            constexpr friend bool operator==(const _subslice_iterator& a, const _subslice_iterator& b) noexcept{
+                return a._m_pos == b._m_pos;
+            }
+        };
+
+        namespace _detail{
+            inline void _check_subslice_size(std::size_t n){
+                if (!n) [[unlikely]]
+                    _CRABI_THROW(std::invalid_argument{"Subslice size must be non-zero"});
+            }
+        }
+
+        template<typename T> struct chunks : std::ranges::view_interface<chunks<T>>{
+        private:
+            slice<T> _m_slice;
+            std::size_t _m_size;
+        public:
+            using iterator = _subslice_iterator<T>;
+
+            constexpr chunks() noexcept : _m_slice{}, _m_size{1}{}
+            constexpr chunks(slice<T> sl, std::size_t n) : _m_slice{sl}, _m_size{n}{
+                _detail::_check_subslice_size(n);
+            }
+
+            constexpr iterator begin() const noexcept{
+                return iterator{_m_slice.data(), _m_slice.size(), _m_size, _m_size};
+            }
+
+            constexpr iterator end() const noexcept{
+                return iterator{_m_slice.data() + _m_slice.size(), 0, _m_size, _m_size};
+            }
+
+            constexpr std::size_t size() const noexcept{
+                return _m_slice.size() / _m_size + (_m_slice.size() % _m_size != 0);
+            }
+        };
+
+        template<typename T> struct chunks_exact : std::ranges::view_interface<chunks_exact<T>>{
+        private:
+            slice<T> _m_slice;
+            std::size_t _m_size;
+        public:
+            using iterator = _subslice_iterator<T>;
+
+            constexpr chunks_exact() noexcept : _m_slice{}, _m_size{1}{}
+            constexpr chunks_exact(slice<T> sl, std::size_t n) : _m_slice{sl}, _m_size{n}{
+                _detail::_check_subslice_size(n);
+            }
+
+            constexpr iterator begin() const noexcept{
+                return iterator{_m_slice.data(), this->size() * _m_size, _m_size, _m_size};
+            }
+
+            constexpr iterator end() const noexcept{
+                return iterator{_m_slice.data() + this->size() * _m_size, 0, _m_size, _m_size};
+            }
+
+            constexpr std::size_t size() const noexcept{
+                return _m_slice.size() / _m_size;
+            }
+
+            /// The trailing elements which do not fill a complete chunk
+            constexpr slice<T> remainder() const noexcept{
+                std::size_t used = this->size() * _m_size;
+                return _m_slice.subslice(used, _m_slice.size() - used);
+            }
+        };
+
+        template<typename T> struct windows : std::ranges::view_interface<windows<T>>{
+        private:
+            slice<T> _m_slice;
+            std::size_t _m_size;
+        public:
+            using iterator = _subslice_iterator<T>;
+
+            constexpr windows() noexcept : _m_slice{}, _m_size{1}{}
+            constexpr windows(slice<T> sl, std::size_t n) : _m_slice{sl}, _m_size{n}{
+                _detail::_check_subslice_size(n);
+            }
+
+            constexpr iterator begin() const noexcept{
+                return iterator{_m_slice.data(), this->size() ? _m_slice.size() : 0, _m_size, 1};
+            }
+
+            constexpr iterator end() const noexcept{
+                return iterator{_m_slice.data() + this->size(), 0, _m_size, 1};
+            }
+
+            constexpr std::size_t size() const noexcept{
+                return _m_slice.size() >= _m_size ? _m_slice.size() - _m_size + 1 : 0;
+            }
+        };
+    }
+
+    namespace _detail{
+        /// The niche representation of `slice<T>`. Like Rust, only the data pointer is inspected, so an empty `option<slice<T>>` received from Rust may have any length
+        template<typename T> struct _slice_niche{
+            T* p_data;
+            std::size_t p_len;
+
+            constexpr friend bool operator==(const _slice_niche& a, const _slice_niche& b) noexcept{
+                return a.p_data == b.p_data;
+            }
         };
     }
 
     template<typename T> struct optional_niche<crabi::slice::slice<T>>{
-        using type = crabi::slice::raw_slice_ptr<T>;
-        constexpr const crabi::slice::raw_slice_ptr value{0,0};
+        using type = crabi::_detail::_slice_niche<T>;
+        static constexpr type value{nullptr, 0};
+        static constexpr std::size_t offset = 0;
+        static constexpr std::size_t size = sizeof(T*);
     };
-}
\ No newline at end of file
+}
+
+template<typename T> constexpr inline bool std::ranges::enable_borrowed_range<crabi::slice::slice<T>> = true;
+template<typename T> constexpr inline bool std::ranges::enable_view<crabi::slice::slice<T>> = true;
+template<typename T> constexpr inline bool std::ranges::enable_borrowed_range<crabi::slice::chunks<T>> = true;
+template<typename T> constexpr inline bool std::ranges::enable_borrowed_range<crabi::slice::chunks_exact<T>> = true;
+template<typename T> constexpr inline bool std::ranges::enable_borrowed_range<crabi::slice::windows<T>> = true;
@@ -0,0 +1,449 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include <crabi/option.hxx>
+#include <crabi/result.hxx>
+#include <crabi/slice.hxx>
+#include <crabi/_simd.hxx>
+#include <crabi/_except.hxx>
+
+namespace crabi{
+    /// The error returned by `str::from_utf8`, equivalent to Rust's `Utf8Error`.
+    /// `p_valid_up_to` is the length of the longest valid prefix. `p_error_len` is the length of the invalid sequence that follows it,
+    /// or is empty if the input ended in the middle of a sequence (which more input may complete)
+    struct utf8_error{
+        std::size_t p_valid_up_to;
+        option<std::uint8_t> p_error_len;
+
+        constexpr friend bool operator==(const utf8_error& a, const utf8_error& b) noexcept{
+            return a.p_valid_up_to == b.p_valid_up_to && a.p_error_len == b.p_error_len;
+        }
+    };
+
+    struct str;
+    struct str_split;
+
+    /// `str` uses the niche of its pointer, so `option<str>` has the same representation as Rust's `Option<&str>`
+    template<> struct optional_niche<str>{
+        using type = optional_niche_t<slice::slice<const char8_t>>;
+        static constexpr type value = optional_niche_v<slice::slice<const char8_t>>;
+        static constexpr std::size_t offset = _detail::_niche_offset_v<slice::slice<const char8_t>>;
+        static constexpr std::size_t size = _detail::_niche_size_v<slice::slice<const char8_t>>;
+    };
+
+    namespace _detail{
+        constexpr bool _is_utf8_continuation(char8_t c) noexcept{
+            return (c & 0xC0) == 0x80;
+        }
+
+        /// The outcome of validating `n` bytes: valid if `_m_valid_up_to == n`, otherwise the fields of the `utf8_error`, with an `_m_error_len` of 0 for an incomplete sequence.
+        /// This is used instead of `option<utf8_error>` so that validation can be performed during constant evaluation
+        struct _utf8_validation{
+            std::size_t _m_valid_up_to;
+            std::uint8_t _m_error_len;
+
+            constexpr friend bool operator==(const _utf8_validation&, const _utf8_validation&) noexcept = default;
+        };
+
+        /// Validates `[p+i, p+n)`, which must begin at a character boundary, as UTF-8 one sequence at a time, with the same rules and error positions as Rust's `core::str::from_utf8`
+        constexpr _utf8_validation _validate_utf8_scalar(const char8_t* p, std::size_t i, std::size_t n) noexcept{
+            while(i < n){
+                if !consteval{
+                    // Skip ASCII a word at a time
+                    while(i + 8 <= n){
+                        std::uint64_t word;
+                        std::memcpy(&word, p + i, sizeof(word));
+                        if(word & 0x8080808080808080u)
+                            break;
+                        i += 8;
+                    }
+                    if(i >= n)
+                        break;
+                }
+                const std::size_t start = i;
+                const char8_t first = p[i];
+                if(first < 0x80){
+                    i++;
+                    continue;
+                }
+
+                auto incomplete = [start]() noexcept{
+                    return _utf8_validation{start, 0};
+                };
+                auto invalid = [start](std::uint8_t len) noexcept{
+                    return _utf8_validation{start, len};
+                };
+
+                std::size_t width;
+                if(first >= 0xC2 && first <= 0xDF)
+                    width = 2;
+                else if(first >= 0xE0 && first <= 0xEF)
+                    width = 3;
+                else if(first >= 0xF0 && first <= 0xF4)
+                    width = 4;
+                else
+                    return invalid(1);
+
+                if(start + 1 >= n)
+                    return incomplete();
+                const char8_t second = p[start + 1];
+                // The range of the second byte excludes overlong encodings, surrogates, and values above U+10FFFF
+                char8_t lo = 0x80, hi = 0xBF;
+                if(first == 0xE0)
+                    lo = 0xA0;
+                else if(first == 0xED)
+                    hi = 0x9F;
+                else if(first == 0xF0)
+                    lo = 0x90;
+                else if(first == 0xF4)
+                    hi = 0x8F;
+                if(second < lo || second > hi)
+                    return invalid(1);
+
+                for(std::size_t k = 2; k < width; k++){
+                    if(start + k >= n)
+                        return incomplete();
+                    if(!_is_utf8_continuation(p[start + k]))
+                        return invalid(static_cast<std::uint8_t>(k));
+                }
+                i = start + width;
+            }
+            return _utf8_validation{n, 0};
+        }
+
+        /// Validates `[p, p+n)` as UTF-8
+        constexpr _utf8_validation _validate_utf8(const char8_t* p, std::size_t n) noexcept{
+            std::size_t start = 0;
+            if !consteval{
+                const unsigned char* bytes = reinterpret_cast<const unsigned char*>(p);
+                start = _simd_validate_utf8(bytes, n);
+                if(start == n)
+                    return _utf8_validation{n, 0};
+                // Resume from the start of the last character before `start`, which may be the one that is in error
+                if(start > 0){
+                    start--;
+                    for(int back = 0; back < 3 && start > 0 && _is_utf8_continuation(p[start]); back++)
+                        start--;
+                }
+            }
+            return _validate_utf8_scalar(p, start, n);
+        }
+
+        /// Encodes `c`, which must be a Unicode scalar value, into `buf`, and returns the number of bytes written
+        constexpr std::size_t _encode_utf8(char32_t c, char8_t (&buf)[4]) noexcept{
+            if(c < 0x80){
+                buf[0] = static_cast<char8_t>(c);
+                return 1;
+            }else if(c < 0x800){
+                buf[0] = static_cast<char8_t>(0xC0 | (c >> 6));
+                buf[1] = static_cast<char8_t>(0x80 | (c & 0x3F));
+                return 2;
+            }else if(c < 0x10000){
+                buf[0] = static_cast<char8_t>(0xE0 | (c >> 12));
+                buf[1] = static_cast<char8_t>(0x80 | ((c >> 6) & 0x3F));
+                buf[2] = static_cast<char8_t>(0x80 | (c & 0x3F));
+                return 3;
+            }else{
+                buf[0] = static_cast<char8_t>(0xF0 | (c >> 18));
+                buf[1] = static_cast<char8_t>(0x80 | ((c >> 12) & 0x3F));
+                buf[2] = static_cast<char8_t>(0x80 | ((c >> 6) & 0x3F));
+                buf[3] = static_cast<char8_t>(0x80 | (c & 0x3F));
+                return 4;
+            }
+        }
+
+        /// Returns the index of the first occurrence of `[needle, needle+m)` in `[p, p+n)`, or `n` if there is none
+        constexpr std::size_t _find_bytes(const char8_t* p, std::size_t n, const char8_t* needle, std::size_t m) noexcept{
+            if !consteval{
+                return _simd_find_bytes(reinterpret_cast<const unsigned char*>(p), n, reinterpret_cast<const unsigned char*>(needle), m);
+            }
+            if(m > n)
+                return n;
+            std::size_t pos = std::u8string_view{p, n}.find(std::u8string_view{needle, m});
+            return pos == std::u8string_view::npos ? n : pos;
+        }
+    }
+
+    /// A borrowed string of UTF-8, equivalent to Rust's `&str`.
+    ///
+    /// A `str` has the same layout as `slice::slice<const char8_t>` (and `&str`): `{ptr, len}`, where the pointer is never null.
+    /// `option<str>` is the same size as `str`, with the same representation as `Option<&str>`.
+    ///
+    /// Every `str` refers to valid UTF-8, which `from_utf8` checks, and which the caller of `from_utf8_unchecked` guarantees (for example, for a `&str` received from Rust)
+    struct str{
+    private:
+        slice::slice<const char8_t> _m_bytes;
+
+        constexpr explicit str(slice::slice<const char8_t> bytes) noexcept : _m_bytes{bytes}{}
+
+        constexpr void _check_boundary(std::size_t i) const{
+            using namespace std::string_view_literals;
+            if(!this->is_char_boundary(i)) [[unlikely]]
+                _CRABI_THROW(std::out_of_range{std::format("Byte index {} is not a char boundary of a string of length {}"sv, i, this->size())});
+        }
+    public:
+        using value_type = char8_t;
+        using size_type = std::size_t;
+
+        /// Creates an empty string
+        constexpr str() noexcept = default;
+
+        /// Creates a `str` from `bytes` without checking that they are valid UTF-8. This is a no-op.
+        /// *Preconditions*: `bytes` is valid UTF-8
+        static constexpr str from_utf8_unchecked(slice::slice<const char8_t> bytes) noexcept{
+            return str{bytes};
+        }
+
+        static constexpr str from_utf8_unchecked(const char8_t* ptr, std::size_t len) noexcept{
+            return str{slice::slice<const char8_t>::from_raw_parts(ptr, len)};
+        }
+
+        /// Checks that `bytes` are valid UTF-8.
+        /// Vectorized with SSSE3 or AVX2 when the processor supports it (see `_simd_validate_utf8`), with a fast path for ASCII otherwise
+        static constexpr result<str, utf8_error> from_utf8(slice::slice<const char8_t> bytes) noexcept{
+            auto v = _detail::_validate_utf8(bytes.data(), bytes.size());
+            if(v._m_valid_up_to != bytes.size())
+                return crabi::err(utf8_error{v._m_valid_up_to, v._m_error_len ? option<std::uint8_t>{v._m_error_len} : option<std::uint8_t>{}});
+            else
+                return str{bytes};
+        }
+
+        static constexpr result<str, utf8_error> from_utf8(std::u8string_view s) noexcept{
+            return from_utf8(slice::slice<const char8_t>::from_raw_parts(s.data(), s.size()));
+        }
+
+        static result<str, utf8_error> from_utf8(std::string_view s) noexcept{
+            return from_utf8(slice::slice<const char8_t>::from_raw_parts(reinterpret_cast<const char8_t*>(s.data()), s.size()));
+        }
+
+        constexpr const char8_t* data() const noexcept{
+            return _m_bytes.data();
+        }
+
+        /// The length of the string in bytes
+        constexpr std::size_t size() const noexcept{
+            return _m_bytes.size();
+        }
+
+        constexpr bool empty() const noexcept{
+            return _m_bytes.empty();
+        }
+
+        constexpr slice::slice<const char8_t> as_bytes() const noexcept{
+            return _m_bytes;
+        }
+
+        constexpr std::u8string_view as_u8string_view() const noexcept{
+            return std::u8string_view{this->data(), this->size()};
+        }
+
+        std::string_view as_string_view() const noexcept{
+            return std::string_view{reinterpret_cast<const char*>(this->data()), this->size()};
+        }
+
+        /// The number of characters (Unicode scalar values) in the string. Vectorized
+        constexpr std::size_t char_count() const noexcept{
+            if !consteval{
+                return _detail::_simd_count_utf8_chars(reinterpret_cast<const unsigned char*>(this->data()), this->size());
+            }
+            std::size_t count = 0;
+            for(char8_t c : this->as_u8string_view())
+                count += !_detail::_is_utf8_continuation(c);
+            return count;
+        }
+
+        /// Whether the byte index `i` is the start of a character or the end of the string
+        constexpr bool is_char_boundary(std::size_t i) const noexcept{
+            if(i == 0 || i == this->size())
+                return true;
+            else if(i > this->size())
+                return false;
+            else
+                return !_detail::_is_utf8_continuation(this->data()[i]);
+        }
+
+        /// The greatest character boundary which is not greater than `i`
+        constexpr std::size_t floor_char_boundary(std::size_t i) const noexcept{
+            if(i >= this->size())
+                return this->size();
+            while(!this->is_char_boundary(i))
+                i--;
+            return i;
+        }
+
+        /// The least character boundary which is not less than `i`, or `size()` if `i` is greater than `size()`
+        constexpr std::size_t ceil_char_boundary(std::size_t i) const noexcept{
+            if(i >= this->size())
+                return this->size();
+            while(!this->is_char_boundary(i))
+                i++;
+            return i;
+        }
+
+        /// Returns the substring `[first, last)`, or an empty `option` if either is not a character boundary or `first > last`
+        constexpr option<str> get(std::size_t first, std::size_t last) const noexcept{
+            if(first > last || !this->is_char_boundary(first) || !this->is_char_boundary(last))
+                return option<str>{};
+            else
+                return option<str>{str{_m_bytes.subslice(first, last - first)}};
+        }
+
+        /// Divides the string into `[0, mid)` and `[mid, size())`.
+        /// Throws `std::out_of_range` if `mid` is not a character boundary
+        constexpr std::pair<str, str> split_at(std::size_t mid) const{
+            this->_check_boundary(mid);
+            return {str{_m_bytes.subslice(0, mid)}, str{_m_bytes.subslice(mid, this->size() - mid)}};
+        }
+
+        /// Returns the byte index of the first occurrence of `pat`, if any. Vectorized
+        constexpr option<std::size_t> find(str pat) const noexcept{
+            std::size_t pos = _detail::_find_bytes(this->data(), this->size(), pat.data(), pat.size());
+            if(pos == this->size() && !pat.empty())
+                return option<std::size_t>{};
+            else
+                return option<std::size_t>{pos};
+        }
+
+        /// Returns the byte index of the first occurrence of the character `c`, if any.
+        /// *Preconditions*: `c` is a Unicode scalar value
+        constexpr option<std::size_t> find(char32_t c) const noexcept{
+            char8_t buf[4]{};
+            std::size_t len = _detail::_encode_utf8(c, buf);
+            return this->find(str::from_utf8_unchecked(buf, len));
+        }
+
+        constexpr bool contains(str pat) const noexcept{
+            return this->find(pat).has_value();
+        }
+
+        constexpr bool contains(char32_t c) const noexcept{
+            return this->find(c).has_value();
+        }
+
+        constexpr bool starts_with(str pat) const noexcept{
+            return _m_bytes.starts_with(pat._m_bytes);
+        }
+
+        constexpr bool ends_with(str pat) const noexcept{
+            return _m_bytes.ends_with(pat._m_bytes);
+        }
+
+        /// Returns a view of the substrings separated by `sep`, as Rust's `str::split`.
+        /// Throws `std::invalid_argument` if `sep` is empty
+        constexpr str_split split(str sep) const;
+
+        /// Splits the string at the first occurrence of `sep`, returning the substrings before and after it
+        constexpr option<std::pair<str, str>> split_once(str sep) const noexcept{
+            if(auto pos = this->find(sep))
+                return option<std::pair<str, str>>{std::pair<str, str>{str{_m_bytes.subslice(0, *pos)}, str{_m_bytes.subslice(*pos + sep.size(), this->size() - *pos - sep.size())}}};
+            else
+                return option<std::pair<str, str>>{};
+        }
+
+        constexpr friend bool operator==(const str& a, const str& b) noexcept{
+            return a._m_bytes == b._m_bytes;
+        }
+
+        /// Compares the strings lexicographically by their bytes, which is the order of their characters
+        constexpr friend std::strong_ordering operator<=>(const str& a, const str& b) noexcept{
+            return a.as_u8string_view() <=> b.as_u8string_view();
+        }
+    };
+
+    /// The view returned by `str::split`
+    struct str_split : std::ranges::view_interface<str_split>{
+    private:
+        str _m_str;
+        str _m_sep;
+    public:
+        struct iterator{
+        private:
+            const char8_t* _m_pos;
+            const char8_t* _m_end;
+            str _m_sep;
+            std::size_t _m_len;
+
+            constexpr void _find_next() noexcept{
+                std::size_t remaining = static_cast<std::size_t>(_m_end - _m_pos);
+                _m_len = _detail::_find_bytes(_m_pos, remaining, _m_sep.data(), _m_sep.size());
+            }
+        public:
+            using value_type = str;
+            using difference_type = std::ptrdiff_t;
+            using iterator_concept = std::forward_iterator_tag;
+
+            constexpr iterator() noexcept : _m_pos{}, _m_end{}, _m_sep{}, _m_len{}{}
+            constexpr iterator(str s, str sep) noexcept : _m_pos{s.data()}, _m_end{s.data() + s.size()}, _m_sep{sep}, _m_len{}{
+                this->_find_next();
+            }
+
+            constexpr str operator*() const noexcept{
+                return str::from_utf8_unchecked(_m_pos, _m_len);
+            }
+
+            constexpr iterator& operator++() noexcept{
+                if(_m_pos + _m_len == _m_end)
+                    _m_pos = nullptr;
+                else{
+                    _m_pos += _m_len + _m_sep.size();
+                    this->_find_next();
+                }
+                return *this;
+            }
+
+            constexpr iterator operator++(int) noexcept{
+                iterator tmp{*this};
+                ++*this;
+                return tmp;
+            }
+
+            constexpr friend bool operator==(const iterator& a, const iterator& b) noexcept{
+                return a._m_pos == b._m_pos;
+            }
+
+            constexpr friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept{
+                return it._m_pos == nullptr;
+            }
+        };
+
+        constexpr str_split() noexcept = default;
+        constexpr str_split(str s, str sep) : _m_str{s}, _m_sep{sep}{
+            if(sep.empty()) [[unlikely]]
+                _CRABI_THROW(std::invalid_argument{"Separator must be non-empty"});
+        }
+
+        constexpr iterator begin() const noexcept{
+            return iterator{_m_str, _m_sep};
+        }
+
+        constexpr std::default_sentinel_t end() const noexcept{
+            return std::default_sentinel;
+        }
+    };
+
+    constexpr str_split str::split(str sep) const{
+        return str_split{*this, sep};
+    }
+
+    namespace literals{
+        /// Creates a `str` from a UTF-8 string literal, which is checked at compile time
+        consteval str operator""_str(const char8_t* s, std::size_t len){
+            if(_detail::_validate_utf8(s, len)._m_valid_up_to != len)
+                _CRABI_THROW(std::invalid_argument{"String literal is not valid UTF-8"});
+            return str::from_utf8_unchecked(s, len);
+        }
+    }
+}
+
+template<> inline constexpr bool std::ranges::enable_borrowed_range<crabi::str_split> = true;
+template<> inline constexpr bool std::ranges::enable_view<crabi::str_split> = true;
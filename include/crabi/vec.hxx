@@ -0,0 +1,585 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <concepts>
+
+#include <crabi/option.hxx>
+#include <crabi/slice.hxx>
+#include <crabi/alloc.hxx>
+
+namespace crabi{
+    /// The raw parts of a `vec<T>`, in the order of Rust's `Vec::from_raw_parts(ptr, length, capacity)`.
+    /// The layout of Rust's `Vec` is unspecified, so ownership is transferred across the FFI boundary through this type
+    template<typename T> struct raw_vec_parts{
+        T* p_data;
+        std::size_t p_len;
+        std::size_t p_cap;
+    };
+
+    template<typename T, typename Alloc> struct boxed_slice;
+
+    namespace _detail{
+        template<typename Alloc, typename T> concept _reallocating_allocator = std::is_trivially_copyable_v<T> && requires(Alloc& alloc, T* ptr, std::size_t n){
+            { alloc.reallocate(ptr, n, n) } -> std::same_as<T*>;
+        };
+
+        /// Deallocates a buffer of `n` elements on scope exit, unless `release()` is called first. This unwinds a partial copy without a `try` block, so that it works with `-fno-exceptions`
+        template<typename Alloc> struct _allocation_guard{
+            Alloc& _m_alloc;
+            typename std::allocator_traits<Alloc>::pointer _m_ptr;
+            std::size_t _m_n;
+
+            constexpr typename std::allocator_traits<Alloc>::pointer release() noexcept{
+                return std::exchange(_m_ptr, nullptr);
+            }
+
+            constexpr ~_allocation_guard() noexcept{
+                if (_m_ptr)
+                    std::allocator_traits<Alloc>::deallocate(_m_alloc, _m_ptr, _m_n);
+            }
+        };
+
+        /// The niche representation of `vec` and `boxed_slice`. Only the data pointer, which is never null, is inspected
+        template<std::size_t N> struct _owned_niche{
+            const void* p_data;
+            unsigned char _m_rest[N - sizeof(void*)];
+
+            constexpr friend bool operator==(const _owned_niche& a, const _owned_niche& b) noexcept{
+                return a.p_data == b.p_data;
+            }
+        };
+    }
+
+    /// A contiguous growable array, equivalent to Rust's `Vec<T>`.
+    ///
+    /// A `vec` is `{ptr, cap, len}` (plus the allocator, if it is not empty). Like Rust, the data pointer is never null, even when nothing is allocated,
+    /// so `option<vec<T>>` is the same size as `vec<T>`.
+    ///
+    /// With the default `system_allocator`, ownership of the buffer can be transferred to Rust without copying:
+    /// pass the result of `into_raw_parts()` to `Vec::from_raw_parts` on the Rust side (which must use the `System` allocator), and use `from_raw_parts` to adopt a `Vec` from Rust.
+    template<typename T, typename Alloc = system_allocator<T>> struct vec{
+    private:
+        using _traits = std::allocator_traits<Alloc>;
+
+        T* _m_ptr;
+        std::size_t _m_cap;
+        std::size_t _m_len;
+        [[no_unique_address]] Alloc _m_alloc;
+
+        constexpr void _release() noexcept{
+            std::destroy_n(_m_ptr, _m_len);
+            if (_m_cap)
+                _traits::deallocate(_m_alloc, _m_ptr, _m_cap);
+        }
+
+        constexpr void _reallocate(std::size_t new_cap){
+            if constexpr(_detail::_reallocating_allocator<Alloc, T>){
+                if (_m_cap){
+                    _m_ptr = _m_alloc.reallocate(_m_ptr, _m_cap, new_cap);
+                    _m_cap = new_cap;
+                    return;
+                }
+            }
+            _detail::_allocation_guard<Alloc> guard{_m_alloc, _traits::allocate(_m_alloc, new_cap), new_cap};
+            if constexpr(std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+                std::uninitialized_move_n(_m_ptr, _m_len, guard._m_ptr);
+            else
+                std::uninitialized_copy_n(_m_ptr, _m_len, guard._m_ptr);
+            T* nptr = guard.release();
+            std::destroy_n(_m_ptr, _m_len);
+            if (_m_cap)
+                _traits::deallocate(_m_alloc, _m_ptr, _m_cap);
+            _m_ptr = nptr;
+            _m_cap = new_cap;
+        }
+
+        constexpr void _grow_for(std::size_t additional){
+            if (additional > std::size_t(-1) / sizeof(T) - _m_len) [[unlikely]]
+                _CRABI_THROW(std::length_error{"vec capacity overflow"});
+            std::size_t need = _m_len + additional;
+            if (need > _m_cap)
+                this->_reallocate(std::max({need, _m_cap * 2, std::size_t{4}}));
+        }
+    public:
+        using value_type = T;
+        using allocator_type = Alloc;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using iterator = T*;
+        using const_iterator = const T*;
+        using reverse_iterator = std::reverse_iterator<T*>;
+        using const_reverse_iterator = std::reverse_iterator<const T*>;
+
+        constexpr vec() noexcept(noexcept(Alloc())) requires std::default_initializable<Alloc> :
+            _m_ptr{slice::_detail::_dangling<T>()}, _m_cap{}, _m_len{}, _m_alloc{}{}
+
+        constexpr explicit vec(const Alloc& alloc) noexcept :
+            _m_ptr{slice::_detail::_dangling<T>()}, _m_cap{}, _m_len{}, _m_alloc{alloc}{}
+
+        /// Creates an empty `vec` with space for at least `cap` elements
+        static constexpr vec with_capacity(std::size_t cap, const Alloc& alloc = Alloc()){
+            vec v{alloc};
+            v.reserve(cap);
+            return v;
+        }
+
+        /// Adopts a buffer of `cap` elements allocated by `alloc`, of which the first `len` are live, for example from Rust's `Vec::into_raw_parts`.
+        /// If `cap` is `0`, `ptr` must not be deallocated by `alloc`
+        static constexpr vec from_raw_parts(T* ptr, std::size_t len, std::size_t cap, const Alloc& alloc = Alloc()) noexcept{
+            vec v{alloc};
+            v._m_ptr = slice::_detail::_non_null(ptr);
+            v._m_len = len;
+            v._m_cap = cap;
+            return v;
+        }
+
+        constexpr vec(std::initializer_list<T> il, const Alloc& alloc = Alloc()) requires std::copy_constructible<T> : vec(alloc){
+            this->reserve(il.size());
+            std::uninitialized_copy_n(il.begin(), il.size(), _m_ptr);
+            _m_len = il.size();
+        }
+
+        /// Copies the elements of `sl` into a new `vec`, like Rust's `<[T]>::to_vec`
+        template<typename U> requires std::same_as<std::remove_cv_t<U>, T> && std::copy_constructible<T>
+            constexpr explicit vec(slice::slice<U> sl, const Alloc& alloc = Alloc()) : vec(alloc){
+                this->reserve(sl.size());
+                std::uninitialized_copy_n(sl.data(), sl.size(), _m_ptr);
+                _m_len = sl.size();
+            }
+
+        constexpr vec(const vec& other) requires std::copy_constructible<T> :
+            vec(slice::slice<const T>{other.data(), other.size()}, _traits::select_on_container_copy_construction(other._m_alloc)){}
+
+        constexpr vec(vec&& other) noexcept :
+            _m_ptr{std::exchange(other._m_ptr, slice::_detail::_dangling<T>())}, _m_cap{std::exchange(other._m_cap, 0)},
+            _m_len{std::exchange(other._m_len, 0)}, _m_alloc{std::move(other._m_alloc)}{}
+
+        constexpr vec& operator=(const vec& other) requires std::copy_constructible<T>{
+            if (this != &other){
+                if constexpr(_traits::propagate_on_container_copy_assignment::value){
+                    vec tmp{other};
+                    this->_release();
+                    _m_ptr = std::exchange(tmp._m_ptr, slice::_detail::_dangling<T>());
+                    _m_cap = std::exchange(tmp._m_cap, 0);
+                    _m_len = std::exchange(tmp._m_len, 0);
+                    _m_alloc = other._m_alloc;
+                }else{
+                    vec tmp{other.as_slice(), _m_alloc};
+                    this->swap(tmp);
+                }
+            }
+            return *this;
+        }
+
+        constexpr vec& operator=(vec&& other) noexcept(_traits::propagate_on_container_move_assignment::value || _traits::is_always_equal::value){
+            if (this != &other){
+                if constexpr(!_traits::propagate_on_container_move_assignment::value && !_traits::is_always_equal::value){
+                    // The buffer of `other` cannot be adopted if it was allocated by an allocator that does not compare equal to ours
+                    if (_m_alloc != other._m_alloc){
+                        this->clear();
+                        this->reserve(other.size());
+                        std::uninitialized_move_n(other._m_ptr, other._m_len, _m_ptr);
+                        _m_len = other._m_len;
+                        other.clear();
+                        return *this;
+                    }
+                }
+                this->_release();
+                _m_ptr = std::exchange(other._m_ptr, slice::_detail::_dangling<T>());
+                _m_cap = std::exchange(other._m_cap, 0);
+                _m_len = std::exchange(other._m_len, 0);
+                if constexpr(_traits::propagate_on_container_move_assignment::value)
+                    _m_alloc = std::move(other._m_alloc);
+            }
+            return *this;
+        }
+
+        constexpr ~vec() noexcept{
+            this->_release();
+        }
+
+        constexpr void swap(vec& other) noexcept{
+            using std::swap;
+            swap(_m_ptr, other._m_ptr);
+            swap(_m_cap, other._m_cap);
+            swap(_m_len, other._m_len);
+            if constexpr(_traits::propagate_on_container_swap::value)
+                swap(_m_alloc, other._m_alloc);
+        }
+
+        constexpr friend void swap(vec& a, vec& b) noexcept{
+            a.swap(b);
+        }
+
+        /// Releases ownership of the buffer. The caller becomes responsible for destroying the elements and deallocating the buffer, for example by passing it to Rust's `Vec::from_raw_parts`
+        [[nodiscard]] constexpr raw_vec_parts<T> into_raw_parts() && noexcept{
+            raw_vec_parts<T> parts{_m_ptr, _m_len, _m_cap};
+            _m_ptr = slice::_detail::_dangling<T>();
+            _m_len = 0;
+            _m_cap = 0;
+            return parts;
+        }
+
+        /// Converts into a `boxed_slice`, reallocating if the capacity exceeds the length
+        constexpr boxed_slice<T, Alloc> into_boxed_slice() &&;
+
+        constexpr allocator_type get_allocator() const noexcept{
+            return _m_alloc;
+        }
+
+        constexpr T* data() noexcept{
+            return _m_ptr;
+        }
+
+        constexpr const T* data() const noexcept{
+            return _m_ptr;
+        }
+
+        constexpr std::size_t size() const noexcept{
+            return _m_len;
+        }
+
+        constexpr std::size_t capacity() const noexcept{
+            return _m_cap;
+        }
+
+        constexpr bool empty() const noexcept{
+            return !_m_len;
+        }
+
+        constexpr iterator begin() noexcept{
+            return _m_ptr;
+        }
+        constexpr const_iterator begin() const noexcept{
+            return _m_ptr;
+        }
+        constexpr const_iterator cbegin() const noexcept{
+            return _m_ptr;
+        }
+        constexpr iterator end() noexcept{
+            return _m_ptr + _m_len;
+        }
+        constexpr const_iterator end() const noexcept{
+            return _m_ptr + _m_len;
+        }
+        constexpr const_iterator cend() const noexcept{
+            return _m_ptr + _m_len;
+        }
+        constexpr reverse_iterator rbegin() noexcept{
+            return reverse_iterator{this->end()};
+        }
+        constexpr const_reverse_iterator rbegin() const noexcept{
+            return const_reverse_iterator{this->end()};
+        }
+        constexpr reverse_iterator rend() noexcept{
+            return reverse_iterator{this->begin()};
+        }
+        constexpr const_reverse_iterator rend() const noexcept{
+            return const_reverse_iterator{this->begin()};
+        }
+
+        constexpr reference operator[](std::size_t i) noexcept{
+            return _m_ptr[i];
+        }
+
+        constexpr const_reference operator[](std::size_t i) const noexcept{
+            return _m_ptr[i];
+        }
+
+        constexpr option<reference> get(std::size_t i) noexcept{
+            if (i >= _m_len)
+                return option<reference>{};
+            else
+                return option<reference>{_m_ptr[i]};
+        }
+
+        constexpr option<const_reference> get(std::size_t i) const noexcept{
+            if (i >= _m_len)
+                return option<const_reference>{};
+            else
+                return option<const_reference>{_m_ptr[i]};
+        }
+
+        constexpr slice::slice<T> as_slice() noexcept{
+            return slice::slice<T>::from_raw_parts(_m_ptr, _m_len);
+        }
+
+        constexpr slice::slice<const T> as_slice() const noexcept{
+            return slice::slice<const T>::from_raw_parts(_m_ptr, _m_len);
+        }
+
+        constexpr operator slice::slice<T>() & noexcept{
+            return this->as_slice();
+        }
+
+        constexpr operator slice::slice<const T>() const& noexcept{
+            return this->as_slice();
+        }
+
+        constexpr void reserve(std::size_t additional){
+            this->_grow_for(additional);
+        }
+
+        constexpr void shrink_to_fit(){
+            if (_m_cap > _m_len){
+                if (_m_len)
+                    this->_reallocate(_m_len);
+                else{
+                    _traits::deallocate(_m_alloc, _m_ptr, _m_cap);
+                    _m_ptr = slice::_detail::_dangling<T>();
+                    _m_cap = 0;
+                }
+            }
+        }
+
+        template<typename... Args> requires std::constructible_from<T, Args&&...>
+            constexpr T& emplace_back(Args&&... args){
+                if (_m_len == _m_cap) [[unlikely]]
+                    this->_grow_for(1);
+                T* elem = std::construct_at(_m_ptr + _m_len, std::forward<Args>(args)...);
+                ++_m_len;
+                return *elem;
+            }
+
+        constexpr void push_back(const T& val) requires std::copy_constructible<T>{
+            this->emplace_back(val);
+        }
+
+        constexpr void push_back(T&& val) requires std::move_constructible<T>{
+            this->emplace_back(std::move(val));
+        }
+
+        /// Removes and returns the last element, if any
+        constexpr option<T> pop_back() noexcept(std::is_nothrow_move_constructible_v<T>) requires std::move_constructible<T>{
+            if (!_m_len)
+                return option<T>{};
+            --_m_len;
+            option<T> ret{std::move(_m_ptr[_m_len])};
+            std::destroy_at(_m_ptr + _m_len);
+            return ret;
+        }
+
+        /// Appends copies of the elements of `sl`
+        template<typename U> requires std::same_as<std::remove_cv_t<U>, T> && std::copy_constructible<T>
+            constexpr void extend_from_slice(slice::slice<U> sl){
+                this->_grow_for(sl.size());
+                std::uninitialized_copy_n(sl.data(), sl.size(), _m_ptr + _m_len);
+                _m_len += sl.size();
+            }
+
+        /// Destroys the elements after the first `len`
+        constexpr void truncate(std::size_t len) noexcept{
+            if (len < _m_len){
+                std::destroy(_m_ptr + len, _m_ptr + _m_len);
+                _m_len = len;
+            }
+        }
+
+        constexpr void clear() noexcept{
+            this->truncate(0);
+        }
+
+        constexpr void resize(std::size_t len) requires std::default_initializable<T>{
+            if (len > _m_len){
+                this->_grow_for(len - _m_len);
+                std::uninitialized_value_construct_n(_m_ptr + _m_len, len - _m_len);
+                _m_len = len;
+            }else
+                this->truncate(len);
+        }
+
+        template<typename U> requires std::equality_comparable_with<const T&, const U&>
+            constexpr friend bool operator==(const vec& a, const vec<U, typename _traits::template rebind_alloc<U>>& b) noexcept(noexcept(a.as_slice() == b.as_slice())){
+                return a.as_slice() == b.as_slice();
+            }
+    };
+
+    /// An owned, fixed-size, heap-allocated array, equivalent to Rust's `Box<[T]>`.
+    ///
+    /// A `boxed_slice` is `{ptr, len}` (plus the allocator, if it is not empty). The data pointer is never null, so `option<boxed_slice<T>>` is the same size as `boxed_slice<T>`.
+    ///
+    /// A `boxed_slice` must not be passed by value across the FFI boundary: it has a non-trivial destructor, so it is passed and returned through memory, where Rust passes `Box<[T]>` in registers.
+    /// Instead, with the default `system_allocator`, pass the result of `into_raw()` to Rust's `Box::from_raw(ptr::slice_from_raw_parts_mut(ptr, len))`, and use `from_raw` to adopt a `Box<[T]>` from Rust.
+    template<typename T, typename Alloc = system_allocator<T>> struct boxed_slice{
+    private:
+        using _traits = std::allocator_traits<Alloc>;
+
+        T* _m_ptr;
+        std::size_t _m_len;
+        [[no_unique_address]] Alloc _m_alloc;
+
+        constexpr void _release() noexcept{
+            std::destroy_n(_m_ptr, _m_len);
+            if (_m_len)
+                _traits::deallocate(_m_alloc, _m_ptr, _m_len);
+        }
+    public:
+        using value_type = T;
+        using allocator_type = Alloc;
+        using reference = T&;
+        using const_reference = const T&;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        constexpr boxed_slice() noexcept(noexcept(Alloc())) requires std::default_initializable<Alloc> :
+            _m_ptr{slice::_detail::_dangling<T>()}, _m_len{}, _m_alloc{}{}
+
+        constexpr explicit boxed_slice(const Alloc& alloc) noexcept :
+            _m_ptr{slice::_detail::_dangling<T>()}, _m_len{}, _m_alloc{alloc}{}
+
+        /// Adopts a buffer of exactly `len` elements allocated by `alloc`, for example from Rust's `Box::<[T]>::into_raw`
+        static constexpr boxed_slice from_raw(slice::raw_slice_ptr<T> raw, const Alloc& alloc = Alloc()) noexcept{
+            boxed_slice b{alloc};
+            b._m_ptr = slice::_detail::_non_null(raw.p_data);
+            b._m_len = raw.p_len;
+            return b;
+        }
+
+        /// Copies the elements of `sl` into a new `boxed_slice`
+        template<typename U> requires std::same_as<std::remove_cv_t<U>, T> && std::copy_constructible<T>
+            constexpr explicit boxed_slice(slice::slice<U> sl, const Alloc& alloc = Alloc()) : boxed_slice(alloc){
+                if (sl.empty())
+                    return;
+                _detail::_allocation_guard<Alloc> guard{_m_alloc, _traits::allocate(_m_alloc, sl.size()), sl.size()};
+                std::uninitialized_copy_n(sl.data(), sl.size(), guard._m_ptr);
+                _m_ptr = guard.release();
+                _m_len = sl.size();
+            }
+
+        constexpr boxed_slice(const boxed_slice& other) requires std::copy_constructible<T> :
+            boxed_slice(slice::slice<const T>{other.data(), other.size()}, _traits::select_on_container_copy_construction(other._m_alloc)){}
+
+        constexpr boxed_slice(boxed_slice&& other) noexcept :
+            _m_ptr{std::exchange(other._m_ptr, slice::_detail::_dangling<T>())}, _m_len{std::exchange(other._m_len, 0)}, _m_alloc{std::move(other._m_alloc)}{}
+
+        constexpr boxed_slice& operator=(boxed_slice other) noexcept{
+            this->swap(other);
+            return *this;
+        }
+
+        constexpr ~boxed_slice() noexcept{
+            this->_release();
+        }
+
+        constexpr void swap(boxed_slice& other) noexcept{
+            using std::swap;
+            swap(_m_ptr, other._m_ptr);
+            swap(_m_len, other._m_len);
+            swap(_m_alloc, other._m_alloc);
+        }
+
+        constexpr friend void swap(boxed_slice& a, boxed_slice& b) noexcept{
+            a.swap(b);
+        }
+
+        /// Releases ownership of the buffer, for example to pass to Rust's `Box::<[T]>::from_raw`
+        [[nodiscard]] constexpr slice::raw_slice_ptr<T> into_raw() && noexcept{
+            slice::raw_slice_ptr<T> raw{_m_ptr, _m_len};
+            _m_ptr = slice::_detail::_dangling<T>();
+            _m_len = 0;
+            return raw;
+        }
+
+        /// Converts into a `vec` whose capacity equals its length, without reallocating
+        constexpr vec<T, Alloc> into_vec() && noexcept{
+            std::size_t len = _m_len;
+            return vec<T, Alloc>::from_raw_parts(std::move(*this).into_raw().p_data, len, len, _m_alloc);
+        }
+
+        constexpr allocator_type get_allocator() const noexcept{
+            return _m_alloc;
+        }
+
+        constexpr T* data() noexcept{
+            return _m_ptr;
+        }
+        constexpr const T* data() const noexcept{
+            return _m_ptr;
+        }
+        constexpr std::size_t size() const noexcept{
+            return _m_len;
+        }
+        constexpr bool empty() const noexcept{
+            return !_m_len;
+        }
+
+        constexpr iterator begin() noexcept{
+            return _m_ptr;
+        }
+        constexpr const_iterator begin() const noexcept{
+            return _m_ptr;
+        }
+        constexpr iterator end() noexcept{
+            return _m_ptr + _m_len;
+        }
+        constexpr const_iterator end() const noexcept{
+            return _m_ptr + _m_len;
+        }
+
+        constexpr reference operator[](std::size_t i) noexcept{
+            return _m_ptr[i];
+        }
+        constexpr const_reference operator[](std::size_t i) const noexcept{
+            return _m_ptr[i];
+        }
+
+        constexpr option<reference> get(std::size_t i) noexcept{
+            if (i >= _m_len)
+                return option<reference>{};
+            else
+                return option<reference>{_m_ptr[i]};
+        }
+
+        constexpr option<const_reference> get(std::size_t i) const noexcept{
+            if (i >= _m_len)
+                return option<const_reference>{};
+            else
+                return option<const_reference>{_m_ptr[i]};
+        }
+
+        constexpr slice::slice<T> as_slice() noexcept{
+            return slice::slice<T>::from_raw_parts(_m_ptr, _m_len);
+        }
+
+        constexpr slice::slice<const T> as_slice() const noexcept{
+            return slice::slice<const T>::from_raw_parts(_m_ptr, _m_len);
+        }
+
+        constexpr operator slice::slice<T>() & noexcept{
+            return this->as_slice();
+        }
+
+        constexpr operator slice::slice<const T>() const& noexcept{
+            return this->as_slice();
+        }
+    };
+
+    template<typename T, typename Alloc> constexpr boxed_slice<T, Alloc> vec<T, Alloc>::into_boxed_slice() &&{
+        this->shrink_to_fit();
+        Alloc alloc = _m_alloc;
+        raw_vec_parts<T> parts = std::move(*this).into_raw_parts();
+        return boxed_slice<T, Alloc>::from_raw(slice::raw_slice_ptr<T>{parts.p_data, parts.p_len}, alloc);
+    }
+
+    template<typename T, typename Alloc> struct optional_niche<vec<T, Alloc>>{
+        using type = _detail::_owned_niche<sizeof(vec<T, Alloc>)>;
+        static constexpr type value{};
+    };
+
+    template<typename T, typename Alloc> struct optional_niche<boxed_slice<T, Alloc>>{
+        using type = _detail::_owned_niche<sizeof(boxed_slice<T, Alloc>)>;
+        static constexpr type value{};
+    };
+}
@@ -0,0 +1,405 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "abi.hxx"
+
+// Checks that each crabi type in `CRABI_ABI_TYPES` has the same size, alignment, bit patterns, and calling convention as the equivalent Rust type, with the Rust functions in `abi.rs`:
+// * The size and alignment reported by Rust are those of the C++ type,
+// * Each sample returned by Rust is the corresponding C++ sample, and both have the given bit pattern,
+// * Each C++ sample passed to Rust is the corresponding Rust sample, and is returned unchanged by Rust,
+// * In `rs_run_checks`, the same checks are made with Rust calling `cxx_make_<name>` and `cxx_echo_<name>`, defined here,
+// * `vec` and `boxed_slice`, which cannot be passed by value, are handed over in each direction through their raw parts.
+//
+// The bit patterns are those of x86_64. `??` is a byte that is not part of the value (padding, or an unused payload), which is not compared.
+// Samples that contain an address have no bit pattern, and are compared by address instead
+
+template<typename T> struct sample{
+    T value;
+    std::string_view pattern;
+};
+
+// Equality of samples, which compares references by address.
+// These are all declared before they are defined, so that the overloads for `option` and `result` find each other
+template<typename T> static bool same(const T& a, const T& b) requires std::equality_comparable<T>;
+template<typename T, std::size_t N> static bool same(const crabi::array<T, N>& a, const crabi::array<T, N>& b);
+template<typename T> static bool same(crabi::ref<T> a, crabi::ref<T> b);
+template<typename T> static bool same(crabi::slice::slice<T> a, crabi::slice::slice<T> b);
+static bool same(crabi::str a, crabi::str b);
+template<typename T> static bool same(const crabi::option<T>& a, const crabi::option<T>& b);
+template<typename T, typename E> static bool same(const crabi::result<T, E>& a, const crabi::result<T, E>& b);
+
+template<typename T> static bool same(const T& a, const T& b) requires std::equality_comparable<T>{
+    return a == b;
+}
+
+template<typename T, std::size_t N> static bool same(const crabi::array<T, N>& a, const crabi::array<T, N>& b){
+    return std::ranges::equal(a, b);
+}
+
+template<typename T> static bool same(crabi::ref<T> a, crabi::ref<T> b){
+    return &*a == &*b;
+}
+
+template<typename T> static bool same(crabi::slice::slice<T> a, crabi::slice::slice<T> b){
+    // Empty slices may have any (non-null, aligned) address
+    return a.size() == b.size() && (a.empty() || a.data() == b.data());
+}
+
+static bool same(crabi::str a, crabi::str b){
+    return same(a.as_bytes(), b.as_bytes());
+}
+
+template<typename T> static bool same(const crabi::option<T>& a, const crabi::option<T>& b){
+    return a.has_value() == b.has_value() && (!a.has_value() || same(*a, *b));
+}
+
+template<typename T, typename E> static bool same(const crabi::result<T, E>& a, const crabi::result<T, E>& b){
+    if(a.is_ok() != b.is_ok())
+        return false;
+    else if(a.is_err())
+        return same(a.error(), b.error());
+    else if constexpr(std::is_reference_v<T>)
+        return &*a == &*b;
+    else
+        return same(*a, *b);
+}
+
+template<typename T> static std::string hex_bytes(const T& val){
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &val, sizeof(T));
+    std::string out;
+    for(unsigned char b : bytes){
+        char buf[4];
+        std::snprintf(buf, sizeof(buf), "%02X ", b);
+        out += buf;
+    }
+    out.pop_back();
+    return out;
+}
+
+template<typename T> static bool matches(const T& val, std::string_view pattern){
+    std::string actual = hex_bytes(val);
+    if(actual.size() != pattern.size())
+        return false;
+    for(std::size_t i = 0; i < pattern.size(); i++){
+        if(pattern[i] != '?' && pattern[i] != actual[i])
+            return false;
+    }
+    return true;
+}
+
+/// Constructs a `T` in memory that is filled with `0xAA`, so that any byte the constructor leaves unwritten (and which Rust may read) shows up in the bit pattern
+template<typename T, typename... Args> static T dirty(Args&&... args){
+    alignas(T) unsigned char buf[sizeof(T)];
+    std::memset(buf, 0xAA, sizeof(buf));
+#if defined(__GNUC__) || defined(__clang__)
+    // Otherwise the compiler may assume the bytes the constructor leaves unwritten are anything, including zero
+    asm volatile("" : : "r"(buf) : "memory");
+#endif
+    T* val = ::new(static_cast<void*>(buf)) T(std::forward<Args>(args)...);
+    T out{*val};
+    val->~T();
+    return out;
+}
+
+static std::uint32_t* mut_u32(std::size_t i){
+    return const_cast<std::uint32_t*>(&crabi_abi_u32s[i]);
+}
+
+static std::vector<sample<abi::option_u32>> samples_option_u32(){
+    return {
+        {dirty<abi::option_u32>(), "00 00 00 00 ?? ?? ?? ??"},
+        {dirty<abi::option_u32>(0u), "01 00 00 00 00 00 00 00"},
+        {dirty<abi::option_u32>(0xDEADBEEFu), "01 00 00 00 EF BE AD DE"},
+    };
+}
+
+static std::vector<sample<abi::option_bool>> samples_option_bool(){
+    return {
+        {abi::option_bool{}, "02"},
+        {abi::option_bool{false}, "00"},
+        {abi::option_bool{true}, "01"},
+    };
+}
+
+static std::vector<sample<abi::option_char>> samples_option_char(){
+    return {
+        {abi::option_char{}, "00 00 11 00"},
+        {abi::option_char{U'a'}, "61 00 00 00"},
+        {abi::option_char{U'\U0001F980'}, "80 F9 01 00"},
+    };
+}
+
+static std::vector<sample<abi::option_option_bool>> samples_option_option_bool(){
+    return {
+        {abi::option_option_bool{}, "03"},
+        {abi::option_option_bool{abi::option_bool{}}, "02"},
+        {abi::option_option_bool{abi::option_bool{false}}, "00"},
+        {abi::option_option_bool{abi::option_bool{true}}, "01"},
+    };
+}
+
+static std::vector<sample<abi::ref_u32>> samples_ref_u32(){
+    return {
+        {abi::ref_u32{crabi_abi_u32s[0]}, ""},
+        {abi::ref_u32{crabi_abi_u32s[2]}, ""},
+    };
+}
+
+static std::vector<sample<abi::option_ref_u32>> samples_option_ref_u32(){
+    return {
+        {abi::option_ref_u32{}, "00 00 00 00 00 00 00 00"},
+        {abi::option_ref_u32{abi::ref_u32{crabi_abi_u32s[1]}}, ""},
+    };
+}
+
+static std::vector<sample<abi::option_non_null_u32>> samples_option_non_null_u32(){
+    return {
+        {abi::option_non_null_u32{}, "00 00 00 00 00 00 00 00"},
+        {abi::option_non_null_u32{crabi::non_null<std::uint32_t>::new_unchecked(mut_u32(3))}, ""},
+    };
+}
+
+static std::vector<sample<abi::slice_u32>> samples_slice_u32(){
+    abi::slice_u32 all{crabi_abi_u32s};
+    return {
+        {all, ""},
+        {all.subslice(1, 2), ""},
+        {abi::slice_u32{}, "?? ?? ?? ?? ?? ?? ?? ?? 00 00 00 00 00 00 00 00"},
+    };
+}
+
+static std::vector<sample<abi::option_slice_u32>> samples_option_slice_u32(){
+    return {
+        {dirty<abi::option_slice_u32>(), "00 00 00 00 00 00 00 00 ?? ?? ?? ?? ?? ?? ?? ??"},
+        {dirty<abi::option_slice_u32>(abi::slice_u32{crabi_abi_u32s}), ""},
+        {dirty<abi::option_slice_u32>(abi::slice_u32{}), ""},
+    };
+}
+
+static std::vector<sample<abi::ref_str>> samples_ref_str(){
+    return {
+        {crabi_abi_str, ""},
+        {*crabi_abi_str.get(0, 1), ""},
+        {abi::ref_str{}, "?? ?? ?? ?? ?? ?? ?? ?? 00 00 00 00 00 00 00 00"},
+    };
+}
+
+static std::vector<sample<abi::option_ref_str>> samples_option_ref_str(){
+    return {
+        {dirty<abi::option_ref_str>(), "00 00 00 00 00 00 00 00 ?? ?? ?? ?? ?? ?? ?? ??"},
+        {dirty<abi::option_ref_str>(crabi_abi_str), ""},
+    };
+}
+
+static std::vector<sample<abi::array_u32_4>> samples_array_u32_4(){
+    return {
+        {abi::array_u32_4{{1, 2, 0xDEADBEEF, 4}}, "01 00 00 00 02 00 00 00 EF BE AD DE 04 00 00 00"},
+        {abi::array_u32_4{{0, 0, 0, 0}}, "00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00"},
+    };
+}
+
+static std::vector<sample<abi::array_u8_3>> samples_array_u8_3(){
+    return {
+        {abi::array_u8_3{{1, 2, 3}}, "01 02 03"},
+    };
+}
+
+static std::vector<sample<abi::result_u32_u32>> samples_result_u32_u32(){
+    return {
+        {dirty<abi::result_u32_u32>(crabi::ok(7u)), "00 00 00 00 07 00 00 00"},
+        {dirty<abi::result_u32_u32>(crabi::err(0xDEADBEEFu)), "01 00 00 00 EF BE AD DE"},
+    };
+}
+
+static std::vector<sample<abi::result_u8_u32>> samples_result_u8_u32(){
+    return {
+        {dirty<abi::result_u8_u32>(crabi::ok(std::uint8_t{5})), "00 05 ?? ?? ?? ?? ?? ??"},
+        {dirty<abi::result_u8_u32>(crabi::err(9u)), "01 ?? ?? ?? 09 00 00 00"},
+    };
+}
+
+static std::vector<sample<abi::result_bool_unit>> samples_result_bool_unit(){
+    return {
+        {abi::result_bool_unit{crabi::ok(false)}, "00"},
+        {abi::result_bool_unit{crabi::ok(true)}, "01"},
+        {abi::result_bool_unit{crabi::err(abi::unit{})}, "02"},
+    };
+}
+
+static std::vector<sample<abi::result_ref_u32_unit>> samples_result_ref_u32_unit(){
+    return {
+        {abi::result_ref_u32_unit{crabi_abi_u32s[0]}, ""},
+        {abi::result_ref_u32_unit{crabi::err(abi::unit{})}, "00 00 00 00 00 00 00 00"},
+    };
+}
+
+static std::vector<sample<abi::option_result_u32_u32>> samples_option_result_u32_u32(){
+    return {
+        {dirty<abi::option_result_u32_u32>(), "02 00 00 00 ?? ?? ?? ??"},
+        {dirty<abi::option_result_u32_u32>(abi::result_u32_u32{crabi::ok(7u)}), "00 00 00 00 07 00 00 00"},
+        {dirty<abi::option_result_u32_u32>(abi::result_u32_u32{crabi::err(8u)}), "01 00 00 00 08 00 00 00"},
+    };
+}
+
+static std::vector<sample<abi::result_slice_u8_u64>> samples_result_slice_u8_u64(){
+    return {
+        {abi::result_slice_u8_u64{crabi::slice::slice<const std::uint8_t>{crabi_abi_u8s}}, ""},
+        {abi::result_slice_u8_u64{crabi::slice::slice<const std::uint8_t>{}}, ""},
+        {dirty<abi::result_slice_u8_u64>(crabi::err(std::uint64_t{0x1122334455667788})), "00 00 00 00 00 00 00 00 88 77 66 55 44 33 22 11"},
+    };
+}
+
+static std::vector<sample<abi::result_slice_u8_u8>> samples_result_slice_u8_u8(){
+    return {
+        {abi::result_slice_u8_u8{crabi::slice::slice<const std::uint8_t>{crabi_abi_u8s}.subslice(1, 3)}, ""},
+        {dirty<abi::result_slice_u8_u8>(crabi::err(std::uint8_t{9})), "00 00 00 00 00 00 00 00 09 ?? ?? ?? ?? ?? ?? ??"},
+    };
+}
+
+static std::vector<sample<abi::result_ref_str_usize>> samples_result_ref_str_usize(){
+    return {
+        {abi::result_ref_str_usize{crabi_abi_str}, ""},
+        {dirty<abi::result_ref_str_usize>(crabi::err(std::size_t{3})), "00 00 00 00 00 00 00 00 03 00 00 00 00 00 00 00"},
+    };
+}
+
+static std::vector<sample<abi::result_u64_slice_u8>> samples_result_u64_slice_u8(){
+    return {
+        {dirty<abi::result_u64_slice_u8>(crabi::ok(std::uint64_t{7})), "00 00 00 00 00 00 00 00 07 00 00 00 00 00 00 00"},
+        {abi::result_u64_slice_u8{crabi::err(crabi::slice::slice<const std::uint8_t>{crabi_abi_u8s}.subslice(0, 2))}, ""},
+    };
+}
+
+static std::vector<sample<abi::result_result_u8_u8_u8>> samples_result_result_u8_u8_u8(){
+    using inner = crabi::result<std::uint8_t, std::uint8_t>;
+    return {
+        {dirty<abi::result_result_u8_u8_u8>(crabi::ok(inner{crabi::ok(std::uint8_t{5})})), "00 05"},
+        {dirty<abi::result_result_u8_u8_u8>(crabi::ok(inner{crabi::err(std::uint8_t{6})})), "01 06"},
+        {dirty<abi::result_result_u8_u8_u8>(crabi::err(std::uint8_t{9})), "02 09"},
+    };
+}
+
+#define CRABI_ABI_DEFINE(name) \
+    extern "C" abi::name cxx_make_##name(std::size_t i){ \
+        return samples_##name()[i].value; \
+    } \
+    extern "C" abi::name cxx_echo_##name(abi::name val){ \
+        return val; \
+    }
+CRABI_ABI_TYPES(CRABI_ABI_DEFINE)
+#undef CRABI_ABI_DEFINE
+
+template<typename T> static unsigned check_type(std::string_view name, const std::vector<sample<T>>& samples,
+    T (*make)(std::size_t), bool (*check)(std::size_t, T), T (*echo)(T), abi::layout (*layout)()){
+    unsigned failures = 0;
+    auto fail = [&](std::size_t i, std::string_view what, const std::string& detail = {}){
+        std::printf("%.*s: sample %zu: %.*s%s\n", static_cast<int>(name.size()), name.data(), i, static_cast<int>(what.size()), what.data(), detail.c_str());
+        failures++;
+    };
+
+    abi::layout l = layout();
+    if(l.size != sizeof(T) || l.align != alignof(T)){
+        std::printf("%.*s: Rust has size %zu and alignment %zu, C++ has size %zu and alignment %zu\n", static_cast<int>(name.size()), name.data(),
+            l.size, l.align, sizeof(T), alignof(T));
+        // The remaining checks would pass values of the wrong size
+        return failures + 1;
+    }
+
+    for(std::size_t i = 0; i < samples.size(); i++){
+        const auto& [expected, pattern] = samples[i];
+        T from_rust = make(i);
+        if(!same(from_rust, expected))
+            fail(i, "Rust value differs from C++ value");
+        if(!pattern.empty()){
+            if(!matches(from_rust, pattern))
+                fail(i, "Rust value has bytes ", hex_bytes(from_rust) + ", expected " + std::string{pattern});
+            if(!matches(expected, pattern))
+                fail(i, "C++ value has bytes ", hex_bytes(expected) + ", expected " + std::string{pattern});
+        }
+        if(!check(i, expected))
+            fail(i, "Rust received a different value from C++");
+        if(!same(echo(expected), expected))
+            fail(i, "Rust returned a different value to C++");
+    }
+    std::printf("%-24.*s %s (size %zu, alignment %zu, %zu samples)\n", static_cast<int>(name.size()), name.data(), failures ? "FAILED" : "ok", sizeof(T), alignof(T), samples.size());
+    return failures;
+}
+
+/// Transfers `vec` and `boxed_slice` buffers between C++ and Rust through their raw parts, in both directions.
+/// Each side grows or frees a buffer allocated by the other, so this also checks that `system_allocator` and Rust's `System` share a heap
+static unsigned check_owned_handoff(){
+    unsigned failures = 0;
+    auto fail = [&](const char* what){
+        std::printf("owned handoff: %s\n", what);
+        failures++;
+    };
+
+    for(std::uint32_t len : {0u, 1u, 100u}){
+        // The sum of the elements `0..len` made by each side
+        std::uint64_t sum = std::uint64_t{len} * (len ? len - 1 : 0) / 2;
+
+        crabi::raw_vec_parts<std::uint32_t> from_rust = rs_make_vec_u32(len);
+        auto v = crabi::vec<std::uint32_t>::from_raw_parts(from_rust.p_data, from_rust.p_len, from_rust.p_cap);
+        bool same_elements = v.size() == len;
+        for(std::uint32_t i = 0; same_elements && i < len; i++)
+            same_elements = v[i] == i;
+        if(!same_elements)
+            fail("vec from Rust has different elements");
+        // Grows past the capacity from Rust, so that `realloc` moves the buffer
+        std::uint64_t expected = sum;
+        for(std::size_t i = v.capacity() + 1; i > 0; i--){
+            v.push_back(1);
+            expected++;
+        }
+        if(rs_take_vec_u32(std::move(v).into_raw_parts()) != expected)
+            fail("vec passed to Rust has different elements");
+
+        auto b = crabi::boxed_slice<std::uint32_t>::from_raw(rs_make_boxed_slice_u32(len));
+        same_elements = b.size() == len;
+        for(std::uint32_t i = 0; same_elements && i < len; i++)
+            same_elements = b[i] == i;
+        if(!same_elements)
+            fail("boxed_slice from Rust has different elements");
+        if(rs_take_boxed_slice_u32(std::move(b).into_raw()) != sum)
+            fail("boxed_slice from Rust, passed back to Rust, has different elements");
+
+        crabi::vec<std::uint32_t> cxx_vec;
+        for(std::uint32_t i = 0; i < len; i++)
+            cxx_vec.push_back(i);
+        auto cxx_boxed = crabi::vec<std::uint32_t>{cxx_vec}.into_boxed_slice();
+        if(rs_take_vec_u32(std::move(cxx_vec).into_raw_parts()) != sum)
+            fail("vec from C++ passed to Rust has different elements");
+        if(rs_take_boxed_slice_u32(std::move(cxx_boxed).into_raw()) != sum)
+            fail("boxed_slice from C++ passed to Rust has different elements");
+    }
+    std::printf("%-24s %s\n", "owned handoff", failures ? "FAILED" : "ok");
+    return failures;
+}
+
+int main(){
+    unsigned failures = 0;
+#define CRABI_ABI_CHECK(name) \
+    failures += check_type<abi::name>(#name, samples_##name(), rs_make_##name, rs_check_##name, rs_echo_##name, rs_layout_##name);
+    CRABI_ABI_TYPES(CRABI_ABI_CHECK)
+#undef CRABI_ABI_CHECK
+
+    failures += check_owned_handoff();
+
+    std::uint32_t rust_failures = rs_run_checks();
+    std::printf("%-24s %s\n", "Rust calling C++", rust_failures ? "FAILED" : "ok");
+    failures += rust_failures;
+
+    if(failures){
+        std::printf("%u ABI mismatches\n", failures);
+        return 1;
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <crabi/array.hxx>
+#include <crabi/non_null.hxx>
+#include <crabi/option.hxx>
+#include <crabi/ref.hxx>
+#include <crabi/result.hxx>
+#include <crabi/slice.hxx>
+#include <crabi/str.hxx>
+#include <crabi/vec.hxx>
+
+#include <cstddef>
+#include <cstdint>
+
+// The declarations of the functions exported by `tests/abi/abi.rs` (used by `tests/abi/abi.cxx`) and `tests/abi/ffi.rs` (used by `tests/bench/ffi.cxx`).
+// Each type in `CRABI_ABI_TYPES` has the same name as in the `abi_types!` invocation in `abi.rs`, where the equivalent Rust type is given.
+
+namespace abi{
+    /// Equivalent to Rust's `()`
+    struct unit{
+        constexpr friend bool operator==(unit, unit) noexcept = default;
+    };
+
+    using option_u32 = crabi::option<std::uint32_t>;
+    using option_bool = crabi::option<bool>;
+    using option_char = crabi::option<char32_t>;
+    using option_option_bool = crabi::option<crabi::option<bool>>;
+    using ref_u32 = crabi::ref<std::uint32_t>;
+    using option_ref_u32 = crabi::option<crabi::ref<std::uint32_t>>;
+    using option_non_null_u32 = crabi::option<crabi::non_null<std::uint32_t>>;
+    using slice_u32 = crabi::slice::slice<const std::uint32_t>;
+    using option_slice_u32 = crabi::option<crabi::slice::slice<const std::uint32_t>>;
+    using ref_str = crabi::str;
+    using option_ref_str = crabi::option<crabi::str>;
+    using array_u32_4 = crabi::array<std::uint32_t, 4>;
+    using array_u8_3 = crabi::array<std::uint8_t, 3>;
+    using result_u32_u32 = crabi::result<std::uint32_t, std::uint32_t>;
+    using result_u8_u32 = crabi::result<std::uint8_t, std::uint32_t>;
+    using result_bool_unit = crabi::result<bool, unit>;
+    using result_ref_u32_unit = crabi::result<const std::uint32_t&, unit>;
+    using option_result_u32_u32 = crabi::option<crabi::result<std::uint32_t, std::uint32_t>>;
+    using result_slice_u8_u64 = crabi::result<crabi::slice::slice<const std::uint8_t>, std::uint64_t>;
+    using result_slice_u8_u8 = crabi::result<crabi::slice::slice<const std::uint8_t>, std::uint8_t>;
+    using result_ref_str_usize = crabi::result<crabi::str, std::size_t>;
+    using result_u64_slice_u8 = crabi::result<std::uint64_t, crabi::slice::slice<const std::uint8_t>>;
+    using result_result_u8_u8_u8 = crabi::result<crabi::result<std::uint8_t, std::uint8_t>, std::uint8_t>;
+
+    struct layout{
+        std::size_t size;
+        std::size_t align;
+    };
+}
+
+#define CRABI_ABI_TYPES(X) \
+    X(option_u32) \
+    X(option_bool) \
+    X(option_char) \
+    X(option_option_bool) \
+    X(ref_u32) \
+    X(option_ref_u32) \
+    X(option_non_null_u32) \
+    X(slice_u32) \
+    X(option_slice_u32) \
+    X(ref_str) \
+    X(option_ref_str) \
+    X(array_u32_4) \
+    X(array_u8_3) \
+    X(result_u32_u32) \
+    X(result_u8_u32) \
+    X(result_bool_unit) \
+    X(result_ref_u32_unit) \
+    X(option_result_u32_u32) \
+    X(result_slice_u8_u64) \
+    X(result_slice_u8_u8) \
+    X(result_ref_str_usize) \
+    X(result_u64_slice_u8) \
+    X(result_result_u8_u8_u8)
+
+extern "C"{
+    extern const crabi::array<std::uint32_t, 4> crabi_abi_u32s;
+    extern const crabi::str crabi_abi_str;
+    extern const crabi::array<std::uint8_t, 4> crabi_abi_u8s;
+
+#define CRABI_ABI_DECLARE(name) \
+    abi::name rs_make_##name(std::size_t i); \
+    bool rs_check_##name(std::size_t i, abi::name val); \
+    abi::name rs_echo_##name(abi::name val); \
+    abi::layout rs_layout_##name();
+    CRABI_ABI_TYPES(CRABI_ABI_DECLARE)
+#undef CRABI_ABI_DECLARE
+
+    std::uint32_t rs_run_checks();
+
+    // The ownership handoff of `vec` and `boxed_slice`, which are not passed by value (see `check_owned_handoff` in `abi.cxx`)
+    crabi::raw_vec_parts<std::uint32_t> rs_make_vec_u32(std::uint32_t len);
+    std::uint64_t rs_take_vec_u32(crabi::raw_vec_parts<std::uint32_t> parts);
+    crabi::slice::raw_slice_ptr<std::uint32_t> rs_make_boxed_slice_u32(std::uint32_t len);
+    std::uint64_t rs_take_boxed_slice_u32(crabi::slice::raw_slice_ptr<std::uint32_t> raw);
+
+    std::uint32_t rs_bench_option_u32(abi::option_u32 val);
+    std::uint32_t rs_bench_raw_option_u32(const std::uint32_t* val);
+    std::uint32_t rs_bench_option_ref_u32(abi::option_ref_u32 val);
+    std::uint32_t rs_bench_raw_ref_u32(const std::uint32_t* val);
+    std::uint32_t rs_bench_slice_u32(abi::slice_u32 val);
+    std::uint32_t rs_bench_raw_slice_u32(const std::uint32_t* ptr, std::size_t len);
+    std::size_t rs_bench_ref_str(abi::ref_str val);
+    std::size_t rs_bench_raw_ref_str(const char8_t* ptr, std::size_t len);
+    std::uint32_t rs_bench_array_u32_4(abi::array_u32_4 val);
+    std::uint32_t rs_bench_raw_array_u32_4(const std::uint32_t (*val)[4]);
+    std::uint32_t rs_bench_result_u32_u32(abi::result_u32_u32 val);
+    std::uint32_t rs_bench_raw_result_u32_u32(const std::uint32_t* ok, const std::uint32_t* err);
+}
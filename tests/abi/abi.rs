@@ -0,0 +1,227 @@
+//! The Rust half of `make abi-test`, built as a staticlib and linked into `tests/abi/abi.cxx`.
+//!
+//! For each type in `abi_types!`, this exports `rs_make_<name>`, `rs_check_<name>`, `rs_echo_<name>` and `rs_layout_<name>`,
+//! which are declared in `tests/abi/abi.hxx`, and imports `cxx_make_<name>` and `cxx_echo_<name>`, which are defined by `tests/abi/abi.cxx`.
+//! The samples of each type must be the same, in the same order, as those in `abi.cxx`.
+//!
+//! The types are passed by value through `extern "C"` functions, whose calling convention follows their layout,
+//! so this also checks that the C++ types are passed in the same registers (or memory) as the Rust types.
+#![allow(improper_ctypes, improper_ctypes_definitions, non_upper_case_globals)]
+
+use core::ptr::NonNull;
+
+#[no_mangle]
+pub static crabi_abi_u32s: [u32; 4] = [1, 2, 0xDEADBEEF, 4];
+
+#[no_mangle]
+pub static crabi_abi_str: &str = "h\u{e9}llo, \u{1F980}";
+
+#[no_mangle]
+pub static crabi_abi_u8s: [u8; 4] = [1, 2, 3, 4];
+
+#[repr(C)]
+pub struct Layout {
+    size: usize,
+    align: usize,
+}
+
+/// Equality of samples, which compares references by address
+trait Same {
+    fn same(&self, other: &Self) -> bool;
+}
+
+macro_rules! same_by_eq {
+    ($($ty:ty),*) => {
+        $(impl Same for $ty {
+            fn same(&self, other: &Self) -> bool {
+                self == other
+            }
+        })*
+    };
+}
+
+same_by_eq!(u8, u32, u64, usize, bool, char, (), [u8; 3], [u32; 4], NonNull<u32>);
+
+impl Same for &u32 {
+    fn same(&self, other: &Self) -> bool {
+        core::ptr::eq(*self, *other)
+    }
+}
+
+impl Same for &[u32] {
+    fn same(&self, other: &Self) -> bool {
+        self.len() == other.len() && (self.is_empty() || self.as_ptr() == other.as_ptr())
+    }
+}
+
+impl Same for &str {
+    fn same(&self, other: &Self) -> bool {
+        self.as_bytes().same(&other.as_bytes())
+    }
+}
+
+impl Same for &[u8] {
+    fn same(&self, other: &Self) -> bool {
+        self.len() == other.len() && (self.is_empty() || self.as_ptr() == other.as_ptr())
+    }
+}
+
+impl<T: Same> Same for Option<T> {
+    fn same(&self, other: &Self) -> bool {
+        match (self, other) {
+            (Some(a), Some(b)) => a.same(b),
+            (None, None) => true,
+            _ => false,
+        }
+    }
+}
+
+impl<T: Same, E: Same> Same for Result<T, E> {
+    fn same(&self, other: &Self) -> bool {
+        match (self, other) {
+            (Ok(a), Ok(b)) => a.same(b),
+            (Err(a), Err(b)) => a.same(b),
+            _ => false,
+        }
+    }
+}
+
+macro_rules! abi_types {
+    ($($name:ident: $ty:ty = [$($sample:expr),* $(,)?];)*) => {
+        $(mod $name {
+            use super::*;
+
+            pub type T = $ty;
+
+            pub fn samples() -> Vec<T> {
+                vec![$($sample),*]
+            }
+
+            extern "C" {
+                #[link_name = concat!("cxx_make_", stringify!($name))]
+                pub fn cxx_make(i: usize) -> T;
+                #[link_name = concat!("cxx_echo_", stringify!($name))]
+                pub fn cxx_echo(val: T) -> T;
+            }
+
+            #[export_name = concat!("rs_make_", stringify!($name))]
+            pub extern "C" fn make(i: usize) -> T {
+                samples()[i]
+            }
+
+            #[export_name = concat!("rs_check_", stringify!($name))]
+            pub extern "C" fn check(i: usize, val: T) -> bool {
+                val.same(&samples()[i])
+            }
+
+            #[export_name = concat!("rs_echo_", stringify!($name))]
+            pub extern "C" fn echo(val: T) -> T {
+                core::hint::black_box(val)
+            }
+
+            #[export_name = concat!("rs_layout_", stringify!($name))]
+            pub extern "C" fn layout() -> Layout {
+                Layout {
+                    size: core::mem::size_of::<T>(),
+                    align: core::mem::align_of::<T>(),
+                }
+            }
+
+            /// Calls the C++ functions for each sample, and returns the number of mismatches
+            pub fn run_checks() -> u32 {
+                let mut failures = 0;
+                for (i, sample) in samples().into_iter().enumerate() {
+                    if !unsafe { cxx_make(i) }.same(&sample) {
+                        eprintln!("{}: cxx_make({}) is not {:?}", stringify!($name), i, sample);
+                        failures += 1;
+                    }
+                    if !unsafe { cxx_echo(sample) }.same(&sample) {
+                        eprintln!("{}: cxx_echo({:?}) returned a different value", stringify!($name), sample);
+                        failures += 1;
+                    }
+                }
+                failures
+            }
+        })*
+
+        /// Runs the checks in the Rust to C++ direction for every type, and returns the number of mismatches
+        #[no_mangle]
+        pub extern "C" fn rs_run_checks() -> u32 {
+            0 $(+ $name::run_checks())*
+        }
+    };
+}
+
+abi_types! {
+    option_u32: Option<u32> = [None, Some(0), Some(0xDEADBEEF)];
+    option_bool: Option<bool> = [None, Some(false), Some(true)];
+    option_char: Option<char> = [None, Some('a'), Some('\u{1F980}')];
+    option_option_bool: Option<Option<bool>> = [None, Some(None), Some(Some(false)), Some(Some(true))];
+    ref_u32: &'static u32 = [&crabi_abi_u32s[0], &crabi_abi_u32s[2]];
+    option_ref_u32: Option<&'static u32> = [None, Some(&crabi_abi_u32s[1])];
+    option_non_null_u32: Option<NonNull<u32>> = [None, Some(NonNull::from(&crabi_abi_u32s[3]))];
+    slice_u32: &'static [u32] = [&crabi_abi_u32s[..], &crabi_abi_u32s[1..3], &[]];
+    option_slice_u32: Option<&'static [u32]> = [None, Some(&crabi_abi_u32s[..]), Some(&[])];
+    ref_str: &'static str = [crabi_abi_str, &crabi_abi_str[..1], ""];
+    option_ref_str: Option<&'static str> = [None, Some(crabi_abi_str)];
+    array_u32_4: [u32; 4] = [[1, 2, 0xDEADBEEF, 4], [0; 4]];
+    array_u8_3: [u8; 3] = [[1, 2, 3]];
+    result_u32_u32: Result<u32, u32> = [Ok(7), Err(0xDEADBEEF)];
+    result_u8_u32: Result<u8, u32> = [Ok(5), Err(9)];
+    result_bool_unit: Result<bool, ()> = [Ok(false), Ok(true), Err(())];
+    result_ref_u32_unit: Result<&'static u32, ()> = [Ok(&crabi_abi_u32s[0]), Err(())];
+    option_result_u32_u32: Option<Result<u32, u32>> = [None, Some(Ok(7)), Some(Err(8))];
+    result_slice_u8_u64: Result<&'static [u8], u64> = [Ok(&crabi_abi_u8s[..]), Ok(&[]), Err(0x1122334455667788)];
+    result_slice_u8_u8: Result<&'static [u8], u8> = [Ok(&crabi_abi_u8s[1..]), Err(9)];
+    result_ref_str_usize: Result<&'static str, usize> = [Ok(crabi_abi_str), Err(3)];
+    result_u64_slice_u8: Result<u64, &'static [u8]> = [Ok(7), Err(&crabi_abi_u8s[..2])];
+    result_result_u8_u8_u8: Result<Result<u8, u8>, u8> = [Ok(Ok(5)), Ok(Err(6)), Err(9)];
+}
+
+/// The raw parts of a `Vec<T>`, as `crabi::raw_vec_parts<T>`
+#[repr(C)]
+pub struct RawVecParts<T> {
+    ptr: *mut T,
+    len: usize,
+    cap: usize,
+}
+
+/// The raw parts of a `Box<[T]>`, as `crabi::slice::raw_slice_ptr<T>`
+#[repr(C)]
+pub struct RawSlice<T> {
+    ptr: *mut T,
+    len: usize,
+}
+
+/// Returns a `Vec` of `0..len`, with spare capacity, for `tests/abi/abi.cxx` to adopt with `crabi::vec::from_raw_parts`
+#[no_mangle]
+pub extern "C" fn rs_make_vec_u32(len: u32) -> RawVecParts<u32> {
+    let mut v: Vec<u32> = Vec::with_capacity(len as usize * 2 + 1);
+    v.extend(0..len);
+    let mut v = core::mem::ManuallyDrop::new(v);
+    RawVecParts { ptr: v.as_mut_ptr(), len: v.len(), cap: v.capacity() }
+}
+
+/// Adopts a `crabi::vec` released by `into_raw_parts`, grows it (reallocating the buffer), and frees it. Returns the sum of the elements, before growing
+#[no_mangle]
+pub unsafe extern "C" fn rs_take_vec_u32(parts: RawVecParts<u32>) -> u64 {
+    let mut v = Vec::from_raw_parts(parts.ptr, parts.len, parts.cap);
+    let sum = v.iter().map(|&x| x as u64).sum();
+    v.extend(core::iter::repeat(0).take(v.capacity() + 1));
+    sum
+}
+
+/// Returns a `Box<[u32]>` of `0..len`, for `tests/abi/abi.cxx` to adopt with `crabi::boxed_slice::from_raw`
+#[no_mangle]
+pub extern "C" fn rs_make_boxed_slice_u32(len: u32) -> RawSlice<u32> {
+    let b: Box<[u32]> = (0..len).collect();
+    let len = b.len();
+    RawSlice { ptr: Box::into_raw(b) as *mut u32, len }
+}
+
+/// Adopts a `crabi::boxed_slice` released by `into_raw`, and frees it. Returns the sum of the elements
+#[no_mangle]
+pub unsafe extern "C" fn rs_take_boxed_slice_u32(raw: RawSlice<u32>) -> u64 {
+    let b = Box::from_raw(core::ptr::slice_from_raw_parts_mut(raw.ptr, raw.len));
+    b.iter().map(|&x| x as u64).sum()
+}
@@ -0,0 +1,64 @@
+//! The Rust half of `make ffi-bench`, built as a staticlib and linked into `tests/bench/ffi.cxx`, which declares these functions in `tests/abi/abi.hxx`.
+//!
+//! Each function takes the Rust equivalent of a crabi type, or the raw pointers that would be used in its place without crabi, and does the least work that uses the value.
+#![allow(improper_ctypes_definitions)]
+
+#[no_mangle]
+pub extern "C" fn rs_bench_option_u32(val: Option<u32>) -> u32 {
+    val.unwrap_or(0)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rs_bench_raw_option_u32(val: *const u32) -> u32 {
+    if val.is_null() { 0 } else { *val }
+}
+
+#[no_mangle]
+pub extern "C" fn rs_bench_option_ref_u32(val: Option<&u32>) -> u32 {
+    val.copied().unwrap_or(0)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rs_bench_raw_ref_u32(val: *const u32) -> u32 {
+    if val.is_null() { 0 } else { *val }
+}
+
+#[no_mangle]
+pub extern "C" fn rs_bench_slice_u32(val: &[u32]) -> u32 {
+    val.last().copied().unwrap_or(0)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rs_bench_raw_slice_u32(ptr: *const u32, len: usize) -> u32 {
+    if len == 0 { 0 } else { *ptr.add(len - 1) }
+}
+
+#[no_mangle]
+pub extern "C" fn rs_bench_ref_str(val: &str) -> usize {
+    val.len()
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rs_bench_raw_ref_str(ptr: *const u8, len: usize) -> usize {
+    core::str::from_utf8_unchecked(core::slice::from_raw_parts(ptr, len)).len()
+}
+
+#[no_mangle]
+pub extern "C" fn rs_bench_array_u32_4(val: [u32; 4]) -> u32 {
+    val[3]
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rs_bench_raw_array_u32_4(val: *const [u32; 4]) -> u32 {
+    (*val)[3]
+}
+
+#[no_mangle]
+pub extern "C" fn rs_bench_result_u32_u32(val: Result<u32, u32>) -> u32 {
+    val.unwrap_or_else(|e| e)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn rs_bench_raw_result_u32_u32(ok: *const u32, err: *const u32) -> u32 {
+    if ok.is_null() { *err } else { *ok }
+}
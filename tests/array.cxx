@@ -13,4 +13,10 @@ int main(){
     assert_eq(a,4);
     assert_eq(b,5);
     assert_eq(c,6);
-}
\ No newline at end of file
+
+    assert_eq(get<2>(y), 6);
+    assert_eq(y == crabi::array{4,5,6}, true);
+    assert_eq(y < z, false);
+    assert_eq(z < y, true);
+    assert_eq(x == crabi::array<int,0>{}, true);
+}
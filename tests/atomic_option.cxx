@@ -0,0 +1,170 @@
+#include <crabi/atomic_option.hxx>
+#include <crabi/non_null.hxx>
+#include <crabi/ref.hxx>
+#include <crabi/slice.hxx>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "test.hxx"
+
+// A single word, and lock-free
+static_assert(sizeof(crabi::atomic_option<crabi::ref<int>>) == sizeof(void*));
+static_assert(sizeof(crabi::atomic_option<const int&>) == sizeof(void*));
+static_assert(sizeof(crabi::atomic_option<bool>) == 1);
+static_assert(crabi::atomic_option<crabi::ref_mut<int>>::is_always_lock_free);
+
+// Not available for an option with a separate discriminant, or that is wider than a word
+static_assert(!crabi::_detail::_atomic_option_storable<std::uint32_t>);
+static_assert(!crabi::_detail::_atomic_option_storable<crabi::slice::slice<int>>);
+
+// Usable as a lazily initialized global
+constinit crabi::atomic_option<const int&> lazy_global;
+
+constexpr unsigned threads = 4;
+
+static bool same_address(const crabi::option<const int&>& a, const int& b){
+    return a.has_value() && &*a == &b;
+}
+
+// Tokens are handed between threads through a few slots. Each thread increments (without synchronization) the token it holds,
+// which is only correct if `take` and `replace` hand each token to exactly one thread, and publish its writes to the next
+static void stress_handoff(){
+    constexpr std::size_t slots_n = 3, iters = 100'000;
+    std::array<int, slots_n> tokens{};
+    std::array<crabi::atomic_option<crabi::ref_mut<int>>, slots_n> slots;
+    for(std::size_t i = 0; i < slots_n; i++)
+        slots[i].store(crabi::ref_mut<int>{tokens[i]});
+
+    std::array<crabi::option<crabi::ref_mut<int>>, threads> held;
+    std::array<std::size_t, threads> increments{};
+    std::vector<std::thread> workers;
+    for(unsigned t = 0; t < threads; t++){
+        workers.emplace_back([&, t]{
+            for(std::size_t i = 0; i < iters; i++){
+                auto& slot = slots[(i + t) % slots_n];
+                if(!held[t])
+                    held[t] = slot.take(std::memory_order_acquire);
+                else{
+                    ++**held[t];
+                    increments[t]++;
+                    held[t] = slot.replace(std::move(held[t]), std::memory_order_acq_rel);
+                }
+            }
+        });
+    }
+    for(auto& w : workers)
+        w.join();
+
+    std::size_t total = 0, counted = 0;
+    for(std::size_t n : increments)
+        total += n;
+    for(int n : tokens)
+        counted += static_cast<std::size_t>(n);
+    assert_eq(counted, total);
+
+    // Every token is in exactly one slot or thread
+    for(int& token : tokens){
+        unsigned found = 0;
+        for(auto& slot : slots){
+            auto val = slot.take();
+            if(val && &**val == &token)
+                found++;
+            if(val)
+                slot.store(std::move(val));
+        }
+        for(auto& h : held)
+            found += h && &**h == &token;
+        assert_eq(found, 1u);
+    }
+}
+
+// Every thread racing to initialize the same cell sees the value stored by the winner
+static void stress_get_or_init(){
+    constexpr std::size_t rounds = 2'000;
+    std::array<int, threads> candidates{};
+    for(std::size_t round = 0; round < rounds; round++){
+        crabi::atomic_option<const int&> cell;
+        std::atomic<unsigned> ready{0};
+        std::array<const int*, threads> seen{};
+        std::vector<std::thread> workers;
+        for(unsigned t = 0; t < threads; t++){
+            workers.emplace_back([&, t]{
+                ready.fetch_add(1);
+                while(ready.load() < threads)
+                    std::this_thread::yield();
+                seen[t] = &cell.get_or_init([&]() -> const int&{ return candidates[t]; });
+            });
+        }
+        for(auto& w : workers)
+            w.join();
+        for(const int* p : seen)
+            assert_eq(same_address(cell.load(), *p), true);
+    }
+}
+
+// A producer and consumer hand a sequence of values through one slot, blocking in `wait` while it is full or empty respectively
+static void stress_wait_notify(){
+    constexpr std::uint32_t count = 20'000;
+    crabi::atomic_option<char32_t> slot;
+    std::thread producer{[&]{
+        for(std::uint32_t i = 0; i < count; i++){
+            while(auto cur = slot.load(std::memory_order_acquire))
+                slot.wait(cur, std::memory_order_acquire);
+            slot.store(static_cast<char32_t>(i), std::memory_order_release);
+            slot.notify_one();
+        }
+    }};
+    for(std::uint32_t i = 0; i < count; i++){
+        crabi::option<char32_t> val;
+        while(!(val = slot.take(std::memory_order_acquire)))
+            slot.wait(std::nullopt, std::memory_order_acquire);
+        slot.notify_one();
+        assert_eq(static_cast<std::uint32_t>(*val), i);
+    }
+    producer.join();
+}
+
+int main(){
+    int a = 1, b = 2;
+
+    crabi::atomic_option<crabi::ref<int>> r;
+    assert_eq(r.load().has_value(), false);
+    assert_eq(r.replace(crabi::ref<int>{a}).has_value(), false);
+    assert_eq(&**r.load() == &a, true);
+    assert_eq(&**r.take() == &a, true);
+    assert_eq(r.take().has_value(), false);
+
+    // `compare_exchange` returns the previous value, as an `ok` if it was stored
+    crabi::atomic_option<crabi::non_null<int>> nn{crabi::non_null<int>::new_unchecked(&a)};
+    auto failed = nn.compare_exchange(std::nullopt, crabi::non_null<int>::new_unchecked(&b));
+    assert_eq(failed.is_err(), true);
+    assert_eq(&**failed.unwrap_err() == &a, true);
+    auto swapped = nn.compare_exchange(crabi::non_null<int>::new_unchecked(&a), crabi::non_null<int>::new_unchecked(&b), std::memory_order_acq_rel);
+    assert_eq(swapped.is_ok(), true);
+    assert_eq(&**nn.load(std::memory_order_acquire) == &b, true);
+
+    // The niche value of `bool` is not zero
+    crabi::atomic_option<bool> flag;
+    assert_eq(flag.load().has_value(), false);
+    flag.store(false);
+    assert_eq(*flag.load(), false);
+    assert_eq(*flag.take(), false);
+    assert_eq(flag.load().has_value(), false);
+
+    // `get_or_init` only invokes `f` while empty
+    unsigned calls = 0;
+    const int& first = lazy_global.get_or_init([&]() -> const int&{ calls++; return a; });
+    const int& second = lazy_global.get_or_init([&]() -> const int&{ calls++; return b; });
+    assert_eq(&first == &a, true);
+    assert_eq(&second == &a, true);
+    assert_eq(calls, 1u);
+
+    stress_handoff();
+    stress_get_or_init();
+    stress_wait_notify();
+}
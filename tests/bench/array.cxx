@@ -0,0 +1,142 @@
+#include <crabi/array.hxx>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bench.hxx"
+
+// Compares `crabi::array<int, 8>` with `std::array<int, 8>`. Each `bench_array_<case>_<crabi|std>` kernel processes a batch of arrays,
+// and each operation is one array of the batch.
+// The kernels are `extern "C"` and not inlined, so that `tests/bench/size.sh` can report the code size of each.
+
+constexpr std::size_t N = 8;
+constexpr std::size_t batch = 256;
+constexpr std::size_t iters = 20'000;
+
+using carr = crabi::array<int, N>;
+using sarr = std::array<int, N>;
+
+template<typename Arr> [[gnu::always_inline]] inline void construct(const int* in, Arr* out) noexcept{
+    for(std::size_t i = 0; i < batch; i++){
+        int v = in[i];
+        out[i] = Arr{{v, v + 1, v ^ 2, v * 3, v - 4, v | 5, v + 6, v * 7}};
+    }
+}
+
+template<typename Arr> [[gnu::always_inline]] inline void copy(const Arr* in, Arr* out) noexcept{
+    for(std::size_t i = 0; i < batch; i++)
+        out[i] = in[i];
+}
+
+template<typename Arr> [[gnu::always_inline]] inline std::size_t compare(const Arr* a, const Arr* b) noexcept{
+    std::size_t n = 0;
+    for(std::size_t i = 0; i < batch; i++)
+        n += (a[i] == b[i]) + (a[i] < b[i]);
+    return n;
+}
+
+template<typename Arr> [[gnu::always_inline]] inline int iterate(const Arr* in) noexcept{
+    int sum = 0;
+    for(std::size_t i = 0; i < batch; i++)
+        for(int v : in[i])
+            sum += v;
+    return sum;
+}
+
+extern "C"{
+    [[gnu::noinline]] void bench_array_construct_crabi(const int* in, carr* out) noexcept{
+        construct(in, out);
+    }
+    [[gnu::noinline]] void bench_array_construct_std(const int* in, sarr* out) noexcept{
+        construct(in, out);
+    }
+
+    [[gnu::noinline]] void bench_array_copy_crabi(const carr* in, carr* out) noexcept{
+        copy(in, out);
+    }
+    [[gnu::noinline]] void bench_array_copy_std(const sarr* in, sarr* out) noexcept{
+        copy(in, out);
+    }
+
+    [[gnu::noinline]] std::size_t bench_array_compare_crabi(const carr* a, const carr* b) noexcept{
+        return compare(a, b);
+    }
+    [[gnu::noinline]] std::size_t bench_array_compare_std(const sarr* a, const sarr* b) noexcept{
+        return compare(a, b);
+    }
+
+    [[gnu::noinline]] int bench_array_iterate_crabi(const carr* in) noexcept{
+        return iterate(in);
+    }
+    [[gnu::noinline]] int bench_array_iterate_std(const sarr* in) noexcept{
+        return iterate(in);
+    }
+
+    [[gnu::noinline]] int bench_array_get_crabi(const carr* in) noexcept{
+        int sum = 0;
+        for(std::size_t i = 0; i < batch; i++)
+            sum += in[i].get<0>() + in[i].get<3>() + in[i].get<N - 1>();
+        return sum;
+    }
+    [[gnu::noinline]] int bench_array_get_std(const sarr* in) noexcept{
+        int sum = 0;
+        for(std::size_t i = 0; i < batch; i++)
+            sum += std::get<0>(in[i]) + std::get<3>(in[i]) + std::get<N - 1>(in[i]);
+        return sum;
+    }
+
+    // A checked lookup whose index is out of bounds for about a ninth of the batch
+    [[gnu::noinline]] int bench_array_try_get_crabi(const carr* in, const std::uint8_t* idx) noexcept{
+        int sum = 0;
+        for(std::size_t i = 0; i < batch; i++){
+            auto val = in[i].try_get(idx[i]);
+            sum += val ? *val : -1;
+        }
+        return sum;
+    }
+    [[gnu::noinline]] int bench_array_try_get_std(const sarr* in, const std::uint8_t* idx) noexcept{
+        int sum = 0;
+        for(std::size_t i = 0; i < batch; i++)
+            sum += idx[i] < in[i].size() ? in[i][idx[i]] : -1;
+        return sum;
+    }
+}
+
+static void report(std::string_view name, std::string_view impl, const bench_result& res){
+    bench_report(std::string{name} + " (" + std::string{impl} + ")", res);
+}
+
+int main(){
+    std::vector<int> values(batch);
+    std::vector<std::uint8_t> indices(batch);
+    std::uint32_t state = 0x9E3779B9;
+    for(std::size_t i = 0; i < batch; i++){
+        state = state * 1664525 + 1013904223;
+        values[i] = static_cast<int>(state >> 16) % 4;
+        indices[i] = static_cast<std::uint8_t>((state >> 8) % (N + 1));
+    }
+    std::vector<carr> crabi_a(batch), crabi_b(batch), crabi_out(batch);
+    std::vector<sarr> std_a(batch), std_b(batch), std_out(batch);
+    bench_array_construct_crabi(values.data(), crabi_a.data());
+    bench_array_construct_std(values.data(), std_a.data());
+    for(std::size_t i = 0; i < batch; i++){
+        crabi_b[i] = crabi_a[(i * 7) % batch];
+        std_b[i] = std_a[(i * 7) % batch];
+    }
+
+    report("construct", "crabi::array", bench_run(iters, batch, [&]{ bench_array_construct_crabi(values.data(), crabi_out.data()); do_not_optimize(crabi_out.data()); }));
+    report("construct", "std::array", bench_run(iters, batch, [&]{ bench_array_construct_std(values.data(), std_out.data()); do_not_optimize(std_out.data()); }));
+    report("copy", "crabi::array", bench_run(iters, batch, [&]{ bench_array_copy_crabi(crabi_a.data(), crabi_out.data()); do_not_optimize(crabi_out.data()); }));
+    report("copy", "std::array", bench_run(iters, batch, [&]{ bench_array_copy_std(std_a.data(), std_out.data()); do_not_optimize(std_out.data()); }));
+    report("== and <", "crabi::array", bench_run(iters, batch, [&]{ do_not_optimize(bench_array_compare_crabi(crabi_a.data(), crabi_b.data())); }));
+    report("== and <", "std::array", bench_run(iters, batch, [&]{ do_not_optimize(bench_array_compare_std(std_a.data(), std_b.data())); }));
+    report("iterate", "crabi::array", bench_run(iters, batch, [&]{ do_not_optimize(bench_array_iterate_crabi(crabi_a.data())); }));
+    report("iterate", "std::array", bench_run(iters, batch, [&]{ do_not_optimize(bench_array_iterate_std(std_a.data())); }));
+    report("get<I>", "crabi::array", bench_run(iters, batch, [&]{ do_not_optimize(bench_array_get_crabi(crabi_a.data())); }));
+    report("std::get<I>", "std::array", bench_run(iters, batch, [&]{ do_not_optimize(bench_array_get_std(std_a.data())); }));
+    report("try_get", "crabi::array", bench_run(iters, batch, [&]{ do_not_optimize(bench_array_try_get_crabi(crabi_a.data(), indices.data())); }));
+    report("bounds check and []", "std::array", bench_run(iters, batch, [&]{ do_not_optimize(bench_array_try_get_std(std_a.data(), indices.data())); }));
+}
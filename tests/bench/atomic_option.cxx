@@ -0,0 +1,101 @@
+#include <crabi/atomic_option.hxx>
+#include <crabi/ref.hxx>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bench.hxx"
+
+// Compares `atomic_option` with an `option` guarded by a `std::mutex`, with every thread operating on the same slot:
+// * handoff: each thread swaps the token it holds with the one in the slot (`replace`), as a hot handoff slot,
+// * get_or_init: each thread reads an already initialized lazy singleton.
+// Each result is the wall-clock time per operation over all threads, so that perfect scaling keeps it constant as threads are added.
+
+constexpr std::size_t iters = 2'000'000;
+
+/// Runs `f(t)` on `threads` threads at once, and returns the wall-clock time per operation, in nanoseconds
+template<typename F> static double contended_ns_per_op(unsigned threads, F&& f){
+    std::atomic<unsigned> ready{0};
+    std::vector<std::thread> workers;
+    std::chrono::steady_clock::time_point start;
+    for(unsigned t = 0; t < threads; t++){
+        workers.emplace_back([&, t]{
+            if(ready.fetch_add(1) + 1 == threads)
+                start = std::chrono::steady_clock::now();
+            while(ready.load() < threads)
+                std::this_thread::yield();
+            f(t);
+        });
+    }
+    for(auto& w : workers)
+        w.join();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iters * threads);
+}
+
+static void report(const char* name, unsigned threads, double ns){
+    char label[96];
+    std::snprintf(label, sizeof(label), "%s (%u threads)", name, threads);
+    bench_report(label, ns);
+}
+
+struct locked_slot{
+    std::mutex mutex;
+    crabi::option<crabi::ref_mut<int>> val;
+};
+
+struct locked_once{
+    std::mutex mutex;
+    crabi::option<const int&> val;
+};
+
+int main(){
+    unsigned max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<int> tokens(std::max(max_threads, 4u) + 1);
+    static const int singleton = 42;
+
+    for(unsigned threads = 1; threads <= std::max(max_threads, 4u); threads *= 2){
+        crabi::atomic_option<crabi::ref_mut<int>> slot{crabi::ref_mut<int>{tokens.back()}};
+        report("atomic_option::replace", threads, contended_ns_per_op(threads, [&](unsigned t){
+            crabi::option<crabi::ref_mut<int>> held{crabi::ref_mut<int>{tokens[t]}};
+            for(std::size_t i = 0; i < iters; i++){
+                held = slot.replace(std::move(held), std::memory_order_acq_rel);
+                do_not_optimize(held);
+            }
+        }));
+
+        locked_slot locked{{}, crabi::ref_mut<int>{tokens.back()}};
+        report("mutex + option::swap", threads, contended_ns_per_op(threads, [&](unsigned t){
+            crabi::option<crabi::ref_mut<int>> held{crabi::ref_mut<int>{tokens[t]}};
+            for(std::size_t i = 0; i < iters; i++){
+                {
+                    std::lock_guard lock{locked.mutex};
+                    locked.val.swap(held);
+                }
+                do_not_optimize(held);
+            }
+        }));
+
+        crabi::atomic_option<const int&> once;
+        report("atomic_option::get_or_init", threads, contended_ns_per_op(threads, [&](unsigned){
+            for(std::size_t i = 0; i < iters; i++)
+                do_not_optimize(&once.get_or_init([]() -> const int&{ return singleton; }));
+        }));
+
+        locked_once locked_init;
+        report("mutex + option (lazy init)", threads, contended_ns_per_op(threads, [&](unsigned){
+            for(std::size_t i = 0; i < iters; i++){
+                std::lock_guard lock{locked_init.mutex};
+                if(!locked_init.val)
+                    locked_init.val = singleton;
+                do_not_optimize(&*locked_init.val);
+            }
+        }));
+    }
+}
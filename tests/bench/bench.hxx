@@ -0,0 +1,131 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// A minimal harness for the benchmarks in this directory, which are run by `make bench`.
+// Each benchmark reports the mean time per operation over a fixed number of iterations, after a warmup run.
+// Where the platform allows it, `bench_run` also reports the mean number of instructions retired per operation.
+// The code size of each `extern "C"` function named `bench_*` is reported by `tests/bench/size.sh` after the benchmark runs.
+
+/// Prevents the compiler from discarding the computation of `val`
+template<typename T> inline void do_not_optimize(const T& val) noexcept{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(val) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &val;
+#endif
+}
+
+/// Invokes `f` `iters` times and returns the mean time per invocation, in nanoseconds
+template<typename F> double bench_ns_per_op(std::size_t iters, F&& f){
+    for(std::size_t i = 0; i < iters / 10 + 1; i++)
+        f();
+    auto start = std::chrono::steady_clock::now();
+    for(std::size_t i = 0; i < iters; i++)
+        f();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iters);
+}
+
+/// Counts the user-space instructions retired by the calling thread.
+/// This requires Linux with access to the hardware counters (`perf_event_paranoid` at most 2, and counters exposed to virtual machines); otherwise `available()` is `false`
+struct bench_instruction_counter{
+private:
+    int _m_fd = -1;
+public:
+    bench_instruction_counter() noexcept{
+#if defined(__linux__)
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        _m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    bench_instruction_counter(const bench_instruction_counter&) = delete;
+    bench_instruction_counter& operator=(const bench_instruction_counter&) = delete;
+
+    ~bench_instruction_counter(){
+#if defined(__linux__)
+        if(_m_fd >= 0)
+            close(_m_fd);
+#endif
+    }
+
+    bool available() const noexcept{
+        return _m_fd >= 0;
+    }
+
+    void start() noexcept{
+#if defined(__linux__)
+        if(_m_fd >= 0){
+            ioctl(_m_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(_m_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    /// Stops counting, and returns the number of instructions since `start`
+    std::uint64_t stop() noexcept{
+        std::uint64_t count = 0;
+#if defined(__linux__)
+        if(_m_fd >= 0){
+            ioctl(_m_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if(read(_m_fd, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count)))
+                count = 0;
+        }
+#endif
+        return count;
+    }
+};
+
+struct bench_result{
+    double ns_per_op;
+    /// Negative if instructions cannot be counted
+    double instructions_per_op;
+};
+
+/// Invokes `f` `iters` times, each of which performs `ops_per_call` operations, and returns the mean time and instructions per operation
+template<typename F> bench_result bench_run(std::size_t iters, std::size_t ops_per_call, F&& f){
+    static bench_instruction_counter counter;
+    for(std::size_t i = 0; i < iters / 10 + 1; i++)
+        f();
+    auto start = std::chrono::steady_clock::now();
+    counter.start();
+    for(std::size_t i = 0; i < iters; i++)
+        f();
+    std::uint64_t instructions = counter.stop();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double ops = static_cast<double>(iters) * static_cast<double>(ops_per_call);
+    return {
+        std::chrono::duration<double, std::nano>(elapsed).count() / ops,
+        counter.available() ? static_cast<double>(instructions) / ops : -1.0,
+    };
+}
+
+inline void bench_report(std::string_view name, double ns_per_op){
+    std::printf("%-48.*s %10.2f ns/op\n", static_cast<int>(name.size()), name.data(), ns_per_op);
+}
+
+inline void bench_report(std::string_view name, const bench_result& res){
+    if(res.instructions_per_op < 0)
+        std::printf("%-48.*s %10.2f ns/op %10s instr/op\n", static_cast<int>(name.size()), name.data(), res.ns_per_op, "n/a");
+    else
+        std::printf("%-48.*s %10.2f ns/op %10.2f instr/op\n", static_cast<int>(name.size()), name.data(), res.ns_per_op, res.instructions_per_op);
+}
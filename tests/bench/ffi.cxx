@@ -0,0 +1,49 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+#include "bench.hxx"
+#include "../abi/abi.hxx"
+
+// Measures the cost of calling Rust (the functions in `tests/abi/ffi.rs`) with crabi types passed by value,
+// against passing the raw pointers that would be used in their place without crabi. The calls cannot be inlined across the language boundary.
+// Run by `make ffi-bench`
+
+constexpr std::size_t iters = 20'000'000;
+
+static void report(std::string_view name, double ns){
+    char label[96];
+    std::snprintf(label, sizeof(label), "%.*s (%.1f M calls/s)", static_cast<int>(name.size()), name.data(), 1e3 / ns);
+    bench_report(label, ns);
+}
+
+template<typename T> static T launder(T val) noexcept{
+    do_not_optimize(val);
+    return val;
+}
+
+int main(){
+    using namespace crabi::literals;
+    const std::uint32_t value = 42;
+    const crabi::array<std::uint32_t, 4> arr{{1, 2, 3, 4}};
+    const crabi::str text = u8"h\u00E9llo, \U0001F980"_str;
+
+    report("option<uint32_t>", bench_ns_per_op(iters, [&]{ do_not_optimize(rs_bench_option_u32(launder(abi::option_u32{value}))); }));
+    report("const uint32_t* (nullable)", bench_ns_per_op(iters, [&]{ do_not_optimize(rs_bench_raw_option_u32(launder(&value))); }));
+
+    report("option<ref<uint32_t>>", bench_ns_per_op(iters, [&]{ do_not_optimize(rs_bench_option_ref_u32(launder(abi::option_ref_u32{abi::ref_u32{value}}))); }));
+    report("const uint32_t*", bench_ns_per_op(iters, [&]{ do_not_optimize(rs_bench_raw_ref_u32(launder(&value))); }));
+
+    report("slice<const uint32_t>", bench_ns_per_op(iters, [&]{ do_not_optimize(rs_bench_slice_u32(launder(abi::slice_u32{arr}))); }));
+    report("const uint32_t*, size_t", bench_ns_per_op(iters, [&]{ do_not_optimize(rs_bench_raw_slice_u32(launder(arr.data()), launder(arr.size()))); }));
+
+    report("str", bench_ns_per_op(iters, [&]{ do_not_optimize(rs_bench_ref_str(launder(text))); }));
+    report("const char8_t*, size_t", bench_ns_per_op(iters, [&]{ do_not_optimize(rs_bench_raw_ref_str(launder(text.data()), launder(text.size()))); }));
+
+    report("array<uint32_t, 4>", bench_ns_per_op(iters, [&]{ do_not_optimize(rs_bench_array_u32_4(launder(arr))); }));
+    report("const uint32_t (*)[4]", bench_ns_per_op(iters, [&]{ do_not_optimize(rs_bench_raw_array_u32_4(launder(&arr._m_items))); }));
+
+    report("result<uint32_t, uint32_t>", bench_ns_per_op(iters, [&]{ do_not_optimize(rs_bench_result_u32_u32(launder(abi::result_u32_u32{crabi::ok(value)}))); }));
+    report("const uint32_t* x2", bench_ns_per_op(iters, [&]{ do_not_optimize(rs_bench_raw_result_u32_u32(launder(&value), launder<const std::uint32_t*>(nullptr))); }));
+}
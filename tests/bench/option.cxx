@@ -0,0 +1,121 @@
+#include <crabi/option.hxx>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "bench.hxx"
+
+// Compares `crabi::option<int>` with `std::optional<int>`. Each `bench_option_<case>_<crabi|std>` kernel processes a batch of options,
+// of which about a third are empty, and each operation is one element of the batch.
+// The kernels are `extern "C"` and not inlined, so that `tests/bench/size.sh` can report the code size of each.
+
+constexpr std::size_t batch = 1024;
+constexpr std::size_t iters = 20'000;
+
+using copt = crabi::option<int>;
+using sopt = std::optional<int>;
+
+template<typename Opt> [[gnu::always_inline]] inline void construct(const int* in, Opt* out) noexcept{
+    for(std::size_t i = 0; i < batch; i++)
+        out[i] = in[i] % 3 ? Opt{in[i]} : Opt{};
+}
+
+template<typename Opt> [[gnu::always_inline]] inline void copy(const Opt* in, Opt* out) noexcept{
+    for(std::size_t i = 0; i < batch; i++)
+        out[i] = in[i];
+}
+
+template<typename Opt> [[gnu::always_inline]] inline std::size_t compare(const Opt* a, const Opt* b) noexcept{
+    std::size_t n = 0;
+    for(std::size_t i = 0; i < batch; i++)
+        n += (a[i] == b[i]) + (a[i] < b[i]);
+    return n;
+}
+
+extern "C"{
+    [[gnu::noinline]] void bench_option_construct_crabi(const int* in, copt* out) noexcept{
+        construct(in, out);
+    }
+    [[gnu::noinline]] void bench_option_construct_std(const int* in, sopt* out) noexcept{
+        construct(in, out);
+    }
+
+    [[gnu::noinline]] void bench_option_copy_crabi(const copt* in, copt* out) noexcept{
+        copy(in, out);
+    }
+    [[gnu::noinline]] void bench_option_copy_std(const sopt* in, sopt* out) noexcept{
+        copy(in, out);
+    }
+
+    [[gnu::noinline]] std::size_t bench_option_compare_crabi(const copt* a, const copt* b) noexcept{
+        return compare(a, b);
+    }
+    [[gnu::noinline]] std::size_t bench_option_compare_std(const sopt* a, const sopt* b) noexcept{
+        return compare(a, b);
+    }
+
+    [[gnu::noinline]] int bench_option_map_and_then_crabi(const copt* in) noexcept{
+        int sum = 0;
+        for(std::size_t i = 0; i < batch; i++)
+            sum += in[i].map([](int x){ return x * 3; })
+                .and_then([](int x){ return x & 1 ? copt{x} : copt{}; })
+                .unwrap_or(0);
+        return sum;
+    }
+    [[gnu::noinline]] int bench_option_map_and_then_std(const sopt* in) noexcept{
+        int sum = 0;
+        for(std::size_t i = 0; i < batch; i++)
+            sum += in[i].transform([](int x){ return x * 3; })
+                .and_then([](int x){ return x & 1 ? sopt{x} : sopt{}; })
+                .value_or(0);
+        return sum;
+    }
+
+    [[gnu::noinline]] int bench_option_unwrap_or_crabi(const copt* in) noexcept{
+        int sum = 0;
+        for(std::size_t i = 0; i < batch; i++)
+            sum += in[i].unwrap_or(-1);
+        return sum;
+    }
+    [[gnu::noinline]] int bench_option_unwrap_or_std(const sopt* in) noexcept{
+        int sum = 0;
+        for(std::size_t i = 0; i < batch; i++)
+            sum += in[i].value_or(-1);
+        return sum;
+    }
+}
+
+static void report(std::string_view name, std::string_view impl, const bench_result& res){
+    bench_report(std::string{name} + " (" + std::string{impl} + ")", res);
+}
+
+int main(){
+    std::vector<int> values(batch);
+    std::uint32_t state = 0x9E3779B9;
+    for(int& v : values){
+        state = state * 1664525 + 1013904223;
+        v = static_cast<int>(state >> 16);
+    }
+    std::vector<copt> crabi_a(batch), crabi_b(batch), crabi_out(batch);
+    std::vector<sopt> std_a(batch), std_b(batch), std_out(batch);
+    bench_option_construct_crabi(values.data(), crabi_a.data());
+    bench_option_construct_std(values.data(), std_a.data());
+    for(std::size_t i = 0; i < batch; i++){
+        crabi_b[i] = crabi_a[(i * 7) % batch];
+        std_b[i] = std_a[(i * 7) % batch];
+    }
+
+    report("construct", "crabi::option", bench_run(iters, batch, [&]{ bench_option_construct_crabi(values.data(), crabi_out.data()); do_not_optimize(crabi_out.data()); }));
+    report("construct", "std::optional", bench_run(iters, batch, [&]{ bench_option_construct_std(values.data(), std_out.data()); do_not_optimize(std_out.data()); }));
+    report("copy", "crabi::option", bench_run(iters, batch, [&]{ bench_option_copy_crabi(crabi_a.data(), crabi_out.data()); do_not_optimize(crabi_out.data()); }));
+    report("copy", "std::optional", bench_run(iters, batch, [&]{ bench_option_copy_std(std_a.data(), std_out.data()); do_not_optimize(std_out.data()); }));
+    report("== and <", "crabi::option", bench_run(iters, batch, [&]{ do_not_optimize(bench_option_compare_crabi(crabi_a.data(), crabi_b.data())); }));
+    report("== and <", "std::optional", bench_run(iters, batch, [&]{ do_not_optimize(bench_option_compare_std(std_a.data(), std_b.data())); }));
+    report("map/and_then/unwrap_or", "crabi::option", bench_run(iters, batch, [&]{ do_not_optimize(bench_option_map_and_then_crabi(crabi_a.data())); }));
+    report("transform/and_then/value_or", "std::optional", bench_run(iters, batch, [&]{ do_not_optimize(bench_option_map_and_then_std(std_a.data())); }));
+    report("unwrap_or", "crabi::option", bench_run(iters, batch, [&]{ do_not_optimize(bench_option_unwrap_or_crabi(crabi_a.data())); }));
+    report("value_or", "std::optional", bench_run(iters, batch, [&]{ do_not_optimize(bench_option_unwrap_or_std(std_a.data())); }));
+}
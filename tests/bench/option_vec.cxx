@@ -0,0 +1,82 @@
+#include <crabi/option_vec.hxx>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "bench.hxx"
+
+// Measures the bulk copy of a column of optional `int`s with `crabi::option_vec::append`, against `std::memcpy` of the same values and bitmap (the lower bound),
+// and against copying a `std::vector<std::optional<int>>`. About a third of the elements are disengaged, and each operation is one element of the column.
+// The kernels are `extern "C"` and not inlined, so that `tests/bench/size.sh` can report the code size of each.
+
+constexpr std::size_t batch = 64 * 1024;
+constexpr std::size_t iters = 2'000;
+
+using cvec = crabi::option_vec<int>;
+using svec = std::vector<std::optional<int>>;
+
+extern "C"{
+    /// Appends to an empty `option_vec`, so the bitmap is copied word-wise
+    [[gnu::noinline]] void bench_option_vec_append_crabi(cvec* out, const cvec* in) noexcept{
+        out->clear();
+        out->append(in->values(), in->bitmap(), in->size());
+    }
+    [[gnu::noinline]] void bench_option_vec_append_memcpy(int* out_values, std::uint64_t* out_bits, const int* in_values, const std::uint64_t* in_bits) noexcept{
+        std::memcpy(out_values, in_values, batch * sizeof(int));
+        std::memcpy(out_bits, in_bits, crabi::_detail::_bitmap_words(batch) * sizeof(std::uint64_t));
+    }
+    [[gnu::noinline]] void bench_option_vec_append_std(svec* out, const svec* in) noexcept{
+        out->assign(in->begin(), in->end());
+    }
+
+    /// Appends after a single element, so each bit of the bitmap is shifted into place
+    [[gnu::noinline]] void bench_option_vec_append_unaligned_crabi(cvec* out, const cvec* in) noexcept{
+        out->resize(1);
+        out->append(in->values(), in->bitmap(), in->size());
+    }
+    [[gnu::noinline]] void bench_option_vec_append_unaligned_std(svec* out, const svec* in) noexcept{
+        out->resize(1);
+        out->insert(out->end(), in->begin(), in->end());
+    }
+}
+
+static void report(std::string_view name, std::string_view impl, const bench_result& res){
+    bench_report(std::string{name} + " (" + std::string{impl} + ")", res);
+}
+
+int main(){
+    cvec crabi_in;
+    svec std_in;
+    std::uint32_t state = 0x9E3779B9;
+    for(std::size_t i = 0; i < batch; i++){
+        state = state * 1664525 + 1013904223;
+        int v = static_cast<int>(state >> 16);
+        if(v % 3){
+            crabi_in.push_back(v);
+            std_in.emplace_back(v);
+        }else{
+            crabi_in.push_none();
+            std_in.emplace_back();
+        }
+    }
+
+    cvec crabi_out;
+    crabi_out.reserve(batch + 1);
+    svec std_out;
+    std_out.reserve(batch + 1);
+    std::vector<int> memcpy_values(batch);
+    std::vector<std::uint64_t> memcpy_bits(crabi::_detail::_bitmap_words(batch));
+
+    report("append", "crabi::option_vec", bench_run(iters, batch, [&]{ bench_option_vec_append_crabi(&crabi_out, &crabi_in); do_not_optimize(crabi_out.values()); }));
+    report("append", "memcpy", bench_run(iters, batch, [&]{
+        bench_option_vec_append_memcpy(memcpy_values.data(), memcpy_bits.data(), crabi_in.values(), crabi_in.bitmap());
+        do_not_optimize(memcpy_values.data());
+    }));
+    report("append", "std::vector<std::optional>", bench_run(iters, batch, [&]{ bench_option_vec_append_std(&std_out, &std_in); do_not_optimize(std_out.data()); }));
+    report("append after 1 element", "crabi::option_vec", bench_run(iters, batch, [&]{ bench_option_vec_append_unaligned_crabi(&crabi_out, &crabi_in); do_not_optimize(crabi_out.values()); }));
+    report("append after 1 element", "std::vector<std::optional>", bench_run(iters, batch, [&]{ bench_option_vec_append_unaligned_std(&std_out, &std_in); do_not_optimize(std_out.data()); }));
+}
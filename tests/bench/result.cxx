@@ -0,0 +1,69 @@
+#include <crabi/array.hxx>
+#include <crabi/result.hxx>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "bench.hxx"
+
+// Compares the error path of `array::checked_at`, which returns a `result`, with that of `array::at`, which throws `std::out_of_range` with a formatted message.
+// Each operation looks up one index, of which the given percentage is out of bounds.
+
+constexpr std::size_t N = 64;
+constexpr std::size_t lookups = 1024;
+
+static crabi::array<std::uint32_t, lookups> make_indices(std::size_t err_percent){
+    crabi::array<std::uint32_t, lookups> indices{};
+    std::uint32_t state = 0x9E3779B9;
+    for(auto& idx : indices){
+        state = state * 1664525 + 1013904223;
+        bool err = (state >> 8) % 100 < err_percent;
+        idx = err ? static_cast<std::uint32_t>(N + (state >> 24) % N) : (state >> 16) % N;
+    }
+    return indices;
+}
+
+[[gnu::noinline]] static std::uint64_t sum_at(const crabi::array<std::uint64_t, N>& arr, const crabi::array<std::uint32_t, lookups>& indices){
+    std::uint64_t sum = 0;
+    for(auto idx : indices){
+        try{
+            sum += arr.at(idx);
+        }catch(const std::out_of_range&){
+            sum += 1;
+        }
+    }
+    return sum;
+}
+
+[[gnu::noinline]] static std::uint64_t sum_checked_at(const crabi::array<std::uint64_t, N>& arr, const crabi::array<std::uint32_t, lookups>& indices){
+    std::uint64_t sum = 0;
+    for(auto idx : indices){
+        auto res = arr.checked_at(idx);
+        if(res)
+            sum += *res;
+        else
+            sum += 1;
+    }
+    return sum;
+}
+
+int main(){
+    crabi::array<std::uint64_t, N> arr{};
+    for(std::size_t i = 0; i < N; i++)
+        arr[i] = i * 3;
+
+    for(std::size_t err_percent : {0, 1, 10, 50, 100}){
+        auto indices = make_indices(err_percent);
+        std::size_t iters = err_percent ? 200 : 20000;
+        double at_ns = bench_ns_per_op(iters, [&]{ do_not_optimize(sum_at(arr, indices)); }) / lookups;
+        double checked_ns = bench_ns_per_op(iters * 10, [&]{ do_not_optimize(sum_checked_at(arr, indices)); }) / lookups;
+        if(sum_at(arr, indices) != sum_checked_at(arr, indices)){
+            std::printf("mismatched results\n");
+            return 1;
+        }
+        bench_report("array::at (throws), " + std::to_string(err_percent) + "% out of bounds", at_ns);
+        bench_report("array::checked_at (result), " + std::to_string(err_percent) + "% out of bounds", checked_ns);
+    }
+}
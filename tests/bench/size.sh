@@ -0,0 +1,30 @@
+#!/bin/sh
+# Usage: size.sh <benchmark binary>
+#
+# Reports the code size of each benchmark kernel, which is an `extern "C"` function named `bench_<group>_<case>_<impl>`,
+# with the kernels of every implementation of the same case on one line. This is the size of the kernel itself, excluding any out-of-line function it calls.
+# Prints nothing if the binary has no kernels.
+
+nm -S --defined-only "$1" | awk '
+    function hex(s,    i, n){
+        n = 0
+        s = tolower(s)
+        for(i = 1; i <= length(s); i++)
+            n = n * 16 + index("0123456789abcdef", substr(s, i, 1)) - 1
+        return n
+    }
+    NF == 4 && ($3 == "T" || $3 == "t") && $4 ~ /^bench_/ {
+        impl = $4
+        sub(/^.*_/, "", impl)
+        kernel = substr($4, 1, length($4) - length(impl) - 1)
+        if(!(kernel in sizes))
+            order[count++] = kernel
+        sizes[kernel] = sizes[kernel] sprintf("  %s %5d bytes", impl, hex($2))
+    }
+    END {
+        if(count)
+            print "Code size:"
+        for(i = 0; i < count; i++)
+            printf "%-48s%s\n", order[i], sizes[order[i]]
+    }
+'
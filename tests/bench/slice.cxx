@@ -0,0 +1,113 @@
+#include <crabi/slice.hxx>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "bench.hxx"
+
+// Compares `crabi::slice::slice<const int>` with `std::span<const int>` over a buffer of `len` integers.
+// Each `bench_slice_<case>_<crabi|std>` kernel visits the whole buffer, and each operation is one element (or, for `subslice`, one subslice).
+// The kernels are `extern "C"` and not inlined, so that `tests/bench/size.sh` can report the code size of each.
+
+constexpr std::size_t len = 4096;
+constexpr std::size_t window = 16;
+constexpr std::size_t iters = 5'000;
+
+using cslice = crabi::slice::slice<const int>;
+using sspan = std::span<const int>;
+
+extern "C"{
+    [[gnu::noinline]] int bench_slice_iterate_crabi(const int* ptr, std::size_t n) noexcept{
+        int sum = 0;
+        for(int v : cslice{ptr, n})
+            sum += v;
+        return sum;
+    }
+    [[gnu::noinline]] int bench_slice_iterate_std(const int* ptr, std::size_t n) noexcept{
+        int sum = 0;
+        for(int v : sspan{ptr, n})
+            sum += v;
+        return sum;
+    }
+
+    [[gnu::noinline]] int bench_slice_reverse_crabi(const int* ptr, std::size_t n) noexcept{
+        cslice s{ptr, n};
+        int sum = 0;
+        for(auto it = s.rbegin(); it != s.rend(); ++it)
+            sum = sum * 3 + *it;
+        return sum;
+    }
+    [[gnu::noinline]] int bench_slice_reverse_std(const int* ptr, std::size_t n) noexcept{
+        sspan s{ptr, n};
+        int sum = 0;
+        for(auto it = s.rbegin(); it != s.rend(); ++it)
+            sum = sum * 3 + *it;
+        return sum;
+    }
+
+    // Constructs each window of `window` elements, and sums their first and last elements
+    [[gnu::noinline]] int bench_slice_subslice_crabi(const int* ptr, std::size_t n) noexcept{
+        cslice s{ptr, n};
+        int sum = 0;
+        for(std::size_t i = 0; i + window <= n; i++){
+            cslice sub = s.subslice(i, window);
+            sum += sub[0] + sub[window - 1];
+        }
+        return sum;
+    }
+    [[gnu::noinline]] int bench_slice_subslice_std(const int* ptr, std::size_t n) noexcept{
+        sspan s{ptr, n};
+        int sum = 0;
+        for(std::size_t i = 0; i + window <= n; i++){
+            sspan sub = s.subspan(i, window);
+            sum += sub[0] + sub[window - 1];
+        }
+        return sum;
+    }
+
+    [[gnu::noinline]] bool bench_slice_contains_crabi(const int* ptr, std::size_t n, int val) noexcept{
+        return cslice{ptr, n}.contains(val);
+    }
+    [[gnu::noinline]] bool bench_slice_contains_std(const int* ptr, std::size_t n, int val) noexcept{
+        sspan s{ptr, n};
+        return std::ranges::find(s, val) != s.end();
+    }
+
+    [[gnu::noinline]] bool bench_slice_equal_crabi(const int* a, const int* b, std::size_t n) noexcept{
+        return cslice{a, n} == cslice{b, n};
+    }
+    [[gnu::noinline]] bool bench_slice_equal_std(const int* a, const int* b, std::size_t n) noexcept{
+        return std::ranges::equal(sspan{a, n}, sspan{b, n});
+    }
+}
+
+static void report(std::string_view name, std::string_view impl, const bench_result& res){
+    bench_report(std::string{name} + " (" + std::string{impl} + ")", res);
+}
+
+int main(){
+    std::vector<int> a(len);
+    std::uint32_t state = 0x9E3779B9;
+    for(int& v : a){
+        state = state * 1664525 + 1013904223;
+        v = static_cast<int>(state >> 16) & 0x7FFF;
+    }
+    std::vector<int> b{a};
+    // Not present, so that `contains` and equality visit every element
+    const int missing = -1;
+
+    report("iterate", "crabi::slice", bench_run(iters, len, [&]{ do_not_optimize(bench_slice_iterate_crabi(a.data(), len)); }));
+    report("iterate", "std::span", bench_run(iters, len, [&]{ do_not_optimize(bench_slice_iterate_std(a.data(), len)); }));
+    report("reverse iterate", "crabi::slice", bench_run(iters, len, [&]{ do_not_optimize(bench_slice_reverse_crabi(a.data(), len)); }));
+    report("reverse iterate", "std::span", bench_run(iters, len, [&]{ do_not_optimize(bench_slice_reverse_std(a.data(), len)); }));
+    report("subslice", "crabi::slice", bench_run(iters, len - window + 1, [&]{ do_not_optimize(bench_slice_subslice_crabi(a.data(), len)); }));
+    report("subspan", "std::span", bench_run(iters, len - window + 1, [&]{ do_not_optimize(bench_slice_subslice_std(a.data(), len)); }));
+    report("contains", "crabi::slice", bench_run(iters, len, [&]{ do_not_optimize(bench_slice_contains_crabi(a.data(), len, missing)); }));
+    report("ranges::find", "std::span", bench_run(iters, len, [&]{ do_not_optimize(bench_slice_contains_std(a.data(), len, missing)); }));
+    report("==", "crabi::slice", bench_run(iters, len, [&]{ do_not_optimize(bench_slice_equal_crabi(a.data(), b.data(), len)); }));
+    report("ranges::equal", "std::span", bench_run(iters, len, [&]{ do_not_optimize(bench_slice_equal_std(a.data(), b.data(), len)); }));
+}
@@ -0,0 +1,64 @@
+#include <crabi/str.hxx>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include "bench.hxx"
+
+// Measures the throughput of `str::from_utf8` against the scalar validator it falls back to, on 1 MiB of text with different mixes of characters.
+// The vectorized validator is selected at runtime on GCC and Clang, so the default flags measure the kernel for the processor running the benchmark.
+// Compiling with `make bench BENCH_CXXFLAGS="-O2 -DNDEBUG -march=native"` selects it at compile time instead
+
+constexpr std::size_t len = 1 << 20;
+
+static std::string make_text(std::u8string_view alphabet){
+    std::string text;
+    text.reserve(len + 4);
+    std::uint32_t state = 0x9E3779B9;
+    while(text.size() < len){
+        state = state * 1664525 + 1013904223;
+        // Pick a whole character from the alphabet, which is valid UTF-8
+        std::size_t pos = (state >> 8) % alphabet.size();
+        while(pos > 0 && (alphabet[pos] & 0xC0) == 0x80)
+            pos--;
+        std::size_t end = pos + 1;
+        while(end < alphabet.size() && (alphabet[end] & 0xC0) == 0x80)
+            end++;
+        text.append(reinterpret_cast<const char*>(alphabet.data() + pos), end - pos);
+    }
+    return text;
+}
+
+static void report(std::string_view name, double ns){
+    char label[96];
+    std::snprintf(label, sizeof(label), "%.*s (%.2f GB/s)", static_cast<int>(name.size()), name.data(), static_cast<double>(len) / ns);
+    bench_report(label, ns);
+}
+
+int main(){
+    struct{
+        std::string_view name;
+        std::u8string_view alphabet;
+    } inputs[] = {
+        {"ascii", u8"the quick brown fox jumps over the lazy dog 0123456789"},
+        {"latin", u8"le cœur déçu mais l'âme plutôt naïve, Louÿs rêva d'un été"},
+        {"cjk", u8"天地玄黄宇宙洪荒日月盈昃辰宿列张"},
+        {"emoji", u8"a🦀b😀c🎉d"},
+    };
+    std::size_t iters = 200;
+    for(auto& input : inputs){
+        std::string text = make_text(input.alphabet);
+        auto ptr = reinterpret_cast<const char8_t*>(text.data());
+        if(!crabi::str::from_utf8(std::string_view{text}).is_ok()){
+            std::printf("input %.*s is not valid\n", static_cast<int>(input.name.size()), input.name.data());
+            return 1;
+        }
+        double simd_ns = bench_ns_per_op(iters, [&]{ do_not_optimize(crabi::str::from_utf8(std::string_view{text})); });
+        double scalar_ns = bench_ns_per_op(iters, [&]{ do_not_optimize(crabi::_detail::_validate_utf8_scalar(ptr, 0, text.size())); });
+        report("str::from_utf8, 1 MiB " + std::string{input.name}, simd_ns);
+        report("scalar validation, 1 MiB " + std::string{input.name}, scalar_ns);
+    }
+}
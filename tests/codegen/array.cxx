@@ -0,0 +1,29 @@
+#include <crabi/array.hxx>
+
+#include <type_traits>
+
+// Each function marked with `codegen-check` is compiled to assembly and inspected by `tests/codegen/check.sh`.
+// `get<I>` is checked at compile time, so it must compile to a single address computation or load, without a branch or a call
+
+static_assert(std::is_trivially_copyable_v<crabi::array<int, 4>>);
+static_assert(sizeof(crabi::array<int, 4>) == 4 * sizeof(int));
+
+// codegen-check: crabi_codegen_array_get nobranch nocall
+extern "C" int& crabi_codegen_array_get(crabi::array<int, 4>& arr) noexcept{
+    return arr.get<2>();
+}
+
+// codegen-check: crabi_codegen_array_get_const nobranch nocall
+extern "C" int crabi_codegen_array_get_const(const crabi::array<int, 4>& arr) noexcept{
+    return arr.get<3>();
+}
+
+// codegen-check: crabi_codegen_array_get_free nobranch nocall
+extern "C" int crabi_codegen_array_get_free(const crabi::array<int, 4>& arr) noexcept{
+    return get<0>(arr) + get<3>(arr);
+}
+
+// codegen-check: crabi_codegen_array_index nobranch nocall
+extern "C" int crabi_codegen_array_index(const crabi::array<int, 4>& arr, std::size_t i) noexcept{
+    return arr[i];
+}
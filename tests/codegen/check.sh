@@ -0,0 +1,57 @@
+#!/bin/sh
+# Usage: check.sh <source.cxx> <assembly.s>
+#
+# Checks the generated (AT&T syntax, x86_64) assembly for each function annotated in the source with
+#  `// codegen-check: <symbol> <rule>...`
+# The following rules are supported:
+# * `regs`: The function body contains no memory operands and does not push or pop, i.e. all arguments and return values are passed in registers
+# * `nobranch`: The function body contains no jumps, conditional or otherwise, i.e. it runs straight through to its `ret`
+# * `nocall`: The function body contains no calls, including tail calls (a `jmp` to a symbol rather than a local `.L` label)
+#
+# A function may be checked with more than one rule, e.g. `// codegen-check: f regs nobranch nocall`.
+# The checks are run by `make codegen`, which fails on the first violation and prints the offending instructions
+
+src="$1"
+asm="$2"
+status=0
+
+body(){
+    awk -v sym="$1" '
+        $0 == sym ":" { inside = 1; next }
+        inside && /^[ \t]*\.size/ { exit }
+        inside && /^[ \t]*\.cfi_endproc/ { exit }
+        inside && !/^[ \t]*\./ && !/^[^ \t]*:/ { print }
+    ' "$asm"
+}
+
+grep -E '^[[:space:]]*//[[:space:]]*codegen-check:' "$src" | sed -e 's/^.*codegen-check://' | while read -r sym rules; do
+    text=$(body "$sym")
+    if [ -z "$text" ]; then
+        echo "$sym: not found in $asm"
+        exit 1
+    fi
+    for rule in $rules; do
+        case "$rule" in
+            regs)
+                bad=$(printf '%s\n' "$text" | grep -E '\(|^[[:space:]]*(push|pop)')
+                ;;
+            nobranch)
+                bad=$(printf '%s\n' "$text" | grep -E '^[[:space:]]*(j[a-z]*|loop[a-z]*)[[:space:]]')
+                ;;
+            nocall)
+                bad=$(printf '%s\n' "$text" | grep -E '^[[:space:]]*call|^[[:space:]]*jmp[a-z]*[[:space:]]+[^.[:space:]]')
+                ;;
+            *)
+                echo "$sym: unknown rule $rule"
+                exit 1
+                ;;
+        esac
+        if [ -n "$bad" ]; then
+            echo "$sym: violates $rule:"
+            printf '%s\n' "$bad"
+            exit 1
+        fi
+    done
+done || status=1
+
+exit $status
@@ -0,0 +1,106 @@
+#include <crabi/option.hxx>
+#include <crabi/ref.hxx>
+
+#include <type_traits>
+
+// Each function marked with `codegen-check` is compiled to assembly and inspected by `tests/codegen/check.sh`.
+// `regs` requires that the function body has no memory operands, i.e. the option is passed and returned in registers (rax/rdx).
+// `nobranch` and `nocall` require that a zero-cost operation compiles to straight-line code, without a test of the discriminant
+
+static_assert(std::is_trivially_copyable_v<crabi::option<int>>);
+static_assert(std::is_trivially_destructible_v<crabi::option<int>>);
+static_assert(std::is_trivially_copy_constructible_v<crabi::option<int>>);
+static_assert(std::is_trivially_move_constructible_v<crabi::option<int>>);
+static_assert(std::is_trivially_copy_assignable_v<crabi::option<int>>);
+static_assert(std::is_trivially_move_assignable_v<crabi::option<int>>);
+
+static_assert(std::is_trivially_copyable_v<crabi::option<long>>);
+static_assert(sizeof(crabi::option<long>) == 2*sizeof(long));
+
+static_assert(std::is_trivially_copyable_v<crabi::option<int&>>);
+static_assert(std::is_trivially_copyable_v<crabi::option<const int&>>);
+static_assert(std::is_trivially_destructible_v<crabi::option<int&>>);
+static_assert(sizeof(crabi::option<int&>) == sizeof(int*));
+
+static_assert(std::is_trivially_copyable_v<crabi::ref<int>>);
+static_assert(std::is_trivially_copyable_v<crabi::option<crabi::ref<int>>>);
+static_assert(std::is_trivially_destructible_v<crabi::option<crabi::ref<int>>>);
+static_assert(sizeof(crabi::option<crabi::ref<int>>) == sizeof(const int*));
+static_assert(std::is_trivially_copyable_v<crabi::option<crabi::ref_mut<int>>>);
+static_assert(sizeof(crabi::option<crabi::ref_mut<int>>) == sizeof(int*));
+
+namespace{
+    struct nontrivial{
+        int _m_val;
+        nontrivial(int val) : _m_val{val}{}
+        nontrivial(const nontrivial& other) : _m_val{other._m_val}{}
+        ~nontrivial(){}
+    };
+}
+
+static_assert(!std::is_trivially_copy_constructible_v<crabi::option<nontrivial>>);
+static_assert(!std::is_trivially_destructible_v<crabi::option<nontrivial>>);
+static_assert(std::is_copy_constructible_v<crabi::option<nontrivial>>);
+static_assert(std::is_destructible_v<crabi::option<nontrivial>>);
+
+// codegen-check: crabi_codegen_option_int_some regs
+extern "C" crabi::option<int> crabi_codegen_option_int_some(int val) noexcept{
+    return crabi::option<int>{val};
+}
+
+// codegen-check: crabi_codegen_option_int_none regs
+extern "C" crabi::option<int> crabi_codegen_option_int_none() noexcept{
+    return crabi::option<int>{};
+}
+
+// codegen-check: crabi_codegen_option_int_unwrap_or regs
+extern "C" int crabi_codegen_option_int_unwrap_or(crabi::option<int> opt, int def) noexcept{
+    return opt.has_value() ? *opt : def;
+}
+
+// codegen-check: crabi_codegen_option_long_some regs
+extern "C" crabi::option<long> crabi_codegen_option_long_some(long val) noexcept{
+    return crabi::option<long>{val};
+}
+
+// codegen-check: crabi_codegen_option_long_forward regs
+extern "C" crabi::option<long> crabi_codegen_option_long_forward(crabi::option<long> opt) noexcept{
+    return opt;
+}
+
+// codegen-check: crabi_codegen_option_lref_some regs
+extern "C" crabi::option<int&> crabi_codegen_option_lref_some(int& val) noexcept{
+    return crabi::option<int&>{val};
+}
+
+// codegen-check: crabi_codegen_option_lref_forward regs
+extern "C" crabi::option<const int&> crabi_codegen_option_lref_forward(crabi::option<const int&> opt) noexcept{
+    return opt;
+}
+
+// codegen-check: crabi_codegen_option_ref_some regs
+extern "C" crabi::option<crabi::ref<int>> crabi_codegen_option_ref_some(const int& val) noexcept{
+    return crabi::option<crabi::ref<int>>{crabi::ref<int>{val}};
+}
+
+// codegen-check: crabi_codegen_option_ref_forward regs
+extern "C" crabi::option<crabi::ref<int>> crabi_codegen_option_ref_forward(crabi::option<crabi::ref<int>> opt) noexcept{
+    return opt;
+}
+
+// `as_ref` of an `option<T&>` is the same pointer, whether or not it is null
+
+// codegen-check: crabi_codegen_option_lref_as_ref regs nobranch nocall
+extern "C" crabi::option<int&> crabi_codegen_option_lref_as_ref(crabi::option<int&> opt) noexcept{
+    return opt.as_ref();
+}
+
+// codegen-check: crabi_codegen_option_lref_as_ref_const nobranch nocall
+extern "C" crabi::option<const int&> crabi_codegen_option_lref_as_ref_const(const crabi::option<const int&>& opt) noexcept{
+    return opt.as_ref();
+}
+
+// codegen-check: crabi_codegen_option_ref_unwrap_or nobranch nocall
+extern "C" const int* crabi_codegen_option_ref_unwrap_or(crabi::option<const int&> opt, const int& def) noexcept{
+    return &opt.unwrap_or(def);
+}
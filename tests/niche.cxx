@@ -0,0 +1,103 @@
+#include <crabi/option.hxx>
+#include <crabi/ref.hxx>
+#include <crabi/non_null.hxx>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "test.hxx"
+
+enum class color : std::uint8_t{
+    red,
+    green,
+    blue,
+};
+
+template<> struct crabi::enum_max<color>{
+    static constexpr color value = color::blue;
+};
+
+enum class unbounded : std::uint8_t{};
+
+// The expected sizes are those of the equivalent Rust types on x86_64
+
+// Option<bool>, Option<Option<bool>>
+static_assert(sizeof(crabi::option<bool>) == 1);
+static_assert(sizeof(crabi::option<crabi::option<bool>>) == 1);
+static_assert(sizeof(crabi::option<crabi::option<crabi::option<bool>>>) == 1);
+
+// Option<char>, Option<Option<char>>
+static_assert(sizeof(crabi::option<char32_t>) == 4);
+static_assert(sizeof(crabi::option<crabi::option<char32_t>>) == 4);
+
+// #[repr(u8)] enum Color{Red, Green, Blue}: Option<Color>, Option<Option<Color>>
+static_assert(sizeof(crabi::option<color>) == 1);
+static_assert(sizeof(crabi::option<crabi::option<color>>) == 1);
+static_assert(sizeof(crabi::option<unbounded>) == 2);
+
+// Option<NonNull<u8>>, Option<*mut u8>
+static_assert(sizeof(crabi::option<crabi::non_null<std::byte>>) == sizeof(std::byte*));
+static_assert(sizeof(crabi::option<std::byte*>) == 2 * sizeof(std::byte*));
+
+// Option<&i32>, Option<Option<&i32>>
+static_assert(sizeof(crabi::option<crabi::ref<int>>) == sizeof(int*));
+static_assert(sizeof(crabi::option<crabi::option<crabi::ref<int>>>) == 2 * sizeof(int*));
+static_assert(sizeof(crabi::option<int&>) == sizeof(int*));
+
+// Option<i32>, Option<f64>
+static_assert(sizeof(crabi::option<std::int32_t>) == 8);
+static_assert(sizeof(crabi::option<double>) == 16);
+
+static_assert(crabi::optional_niche_count_v<bool> == 254);
+static_assert(crabi::optional_niche_count_v<crabi::option<bool>> == 253);
+static_assert(crabi::optional_niche_count_v<crabi::ref<int>> == 1);
+static_assert(crabi::optional_niche_count_v<crabi::option<crabi::ref<int>>> == 0);
+static_assert(crabi::optional_niche_count_v<int> == 0);
+
+template<typename T> std::uint8_t byte_of(const T& val){
+    static_assert(sizeof(T) == 1);
+    return std::bit_cast<std::uint8_t>(val);
+}
+
+int main(){
+    crabi::option<bool> b_none{};
+    crabi::option<bool> b_true{true};
+    crabi::option<bool> b_false{false};
+    assert_eq(b_none.has_value(), false);
+    assert_eq(b_true.has_value(), true);
+    assert_eq(b_false.has_value(), true);
+    assert_eq(*b_false, false);
+    assert_eq(byte_of(b_none), 2);
+    assert_eq(byte_of(b_true), 1);
+
+    // Some(None) is 2 and None is 3, as in Rust
+    crabi::option<crabi::option<bool>> bb_some_none{crabi::option<bool>{}};
+    crabi::option<crabi::option<bool>> bb_none{};
+    crabi::option<crabi::option<bool>> bb_some_some{crabi::option<bool>{true}};
+    assert_eq(bb_some_none.has_value(), true);
+    assert_eq(bb_some_none->has_value(), false);
+    assert_eq(bb_none.has_value(), false);
+    assert_eq(**bb_some_some, true);
+    assert_eq(byte_of(bb_some_none), 2);
+    assert_eq(byte_of(bb_none), 3);
+
+    crabi::option<char32_t> c_none{};
+    crabi::option<char32_t> c_max{U'\U0010FFFF'};
+    assert_eq(std::bit_cast<std::uint32_t>(c_none), 0x110000u);
+    assert_eq(c_max.has_value(), true);
+
+    crabi::option<color> col_none{};
+    crabi::option<color> col_blue{color::blue};
+    assert_eq(byte_of(col_none), 3);
+    assert_eq(col_blue.has_value(), true);
+    assert_eq(*col_blue == color::blue, true);
+
+    int x = 5;
+    auto nn = crabi::non_null<int>::from_ptr(&x);
+    auto nn_none = crabi::non_null<int>::from_ptr(nullptr);
+    assert_eq(nn.has_value(), true);
+    assert_eq(**nn, 5);
+    assert_eq(nn_none.has_value(), false);
+    assert_eq(std::bit_cast<int*>(nn_none) == nullptr, true);
+}
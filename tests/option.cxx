@@ -1,8 +1,46 @@
 #include <crabi/option.hxx>
+#include <crabi/ref.hxx>
+
+#include <compare>
+#include <cstdint>
+#include <cstring>
 
 #include "test.hxx"
 
 using namespace std::string_view_literals;
 
+// The discriminant of Option<u16>, Option<u32> and Option<u64> is as wide as the payload's alignment, and Rust reads all of it
+static_assert(sizeof(crabi::option<std::uint16_t>) == 4);
+static_assert(sizeof(crabi::option<std::uint32_t>) == 8);
+static_assert(sizeof(crabi::option<std::uint64_t>) == 16);
+
+template<typename Tag, typename T> static Tag tag_of(const crabi::option<T>& opt){
+    Tag tag;
+    std::memcpy(&tag, &opt, sizeof(tag));
+    return tag;
+}
+
 int main(){
-}
\ No newline at end of file
+    crabi::option<std::uint32_t> some32{0xFFFFFFFFu};
+    assert_eq(tag_of<std::uint32_t>(some32), 1u);
+    some32 = std::nullopt;
+    assert_eq(tag_of<std::uint32_t>(some32), 0u);
+    crabi::option<std::uint64_t> some64{std::uint64_t{5}};
+    assert_eq(tag_of<std::uint64_t>(some64), std::uint64_t{1});
+    assert_eq(tag_of<std::uint16_t>(crabi::option<std::uint16_t>{}), std::uint16_t{0});
+
+    // Swapping moves a value that cannot be copied into the empty option
+    int x = 1;
+    crabi::option<crabi::ref_mut<int>> full{crabi::ref_mut<int>{x}}, empty;
+    full.swap(empty);
+    assert_eq(full.has_value(), false);
+    assert_eq(&**empty == &x, true);
+
+    // An empty option orders before any value
+    crabi::option<int> none_int, one{1}, two{2};
+    assert_eq(strong_order(none_int, one) == std::strong_ordering::less, true);
+    assert_eq(strong_order(two, one) == std::strong_ordering::greater, true);
+    assert_eq(strong_order(none_int, crabi::option<int>{}) == std::strong_ordering::equivalent, true);
+    assert_eq(weak_order(one, none_int) == std::weak_ordering::greater, true);
+    assert_eq(weak_order(one, crabi::option<int>{1}) == std::weak_ordering::equivalent, true);
+}
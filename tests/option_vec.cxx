@@ -0,0 +1,88 @@
+#include <crabi/option_vec.hxx>
+
+#include <vector>
+
+#include "test.hxx"
+
+int main(){
+    crabi::option_vec<double> v;
+    for(int i = 0; i < 200; i++){
+        if(i % 3 == 0)
+            v.push_none();
+        else
+            v.push_back(static_cast<double>(i));
+    }
+
+    assert_eq(v.size(), 200uz);
+    assert_eq(v.count_none(), 67uz);
+    assert_eq(v.count_some(), 133uz);
+    assert_eq(v.is_some(1), true);
+    assert_eq(v.is_none(3), true);
+    assert_eq(*v[2], 2.0);
+    assert_eq(v[3].has_value(), false);
+    assert_eq(v.get(200).has_value(), false);
+
+    std::size_t visited = 0;
+    v.for_each_some([&](std::size_t i, double& val){
+        assert_eq(val, static_cast<double>(i));
+        visited++;
+    });
+    assert_eq(visited, 133uz);
+
+    std::vector<double> out(200);
+    v.unwrap_or(-1.0, out.begin());
+    for(std::size_t i = 0; i < 200; i++)
+        assert_eq(out[i], i % 3 == 0 ? -1.0 : static_cast<double>(i));
+
+    std::vector<double> part(10);
+    v.unwrap_or(60, 70, 0.0, part.begin());
+    assert_eq(part[0], 0.0);
+    assert_eq(part[1], 61.0);
+
+    std::size_t engaged = 0;
+    for(auto opt : v)
+        engaged += opt.has_value();
+    assert_eq(engaged, 133uz);
+
+    crabi::option_vec<double> w;
+    w.push_none();
+    w.append(v.values(), v.bitmap(), v.size());
+    assert_eq(w.size(), 201uz);
+    assert_eq(w.count_some(), 133uz);
+    assert_eq(*w[3], 2.0);
+
+    // Appending a container to itself reallocates the source, which must be read first
+    w.append(w.values(), w.bitmap(), w.size());
+    assert_eq(w.size(), 402uz);
+    assert_eq(w.count_some(), 266uz);
+    assert_eq(*w[204], 2.0);
+    assert_eq(w[201].has_value(), false);
+
+    // Appending at each offset within a bitmap word shifts the source bitmap into place
+    for(std::size_t prefix = 0; prefix < 130; prefix += 7){
+        crabi::option_vec<double> x(prefix);
+        x.append(v.values(), v.bitmap(), 150);
+        assert_eq(x.count_some(), v.count_some() - 33uz);
+        for(std::size_t i = 0; i < 150; i++)
+            assert_eq(x.is_some(prefix + i), v.is_some(i));
+    }
+
+    v.resize(70);
+    assert_eq(v.count_some(), 46uz);
+    v.resize(200);
+    assert_eq(v.count_some(), 46uz);
+
+    v.fill_none();
+    assert_eq(v.count_some(), 0uz);
+
+    crabi::option_array<int, 100> arr;
+    assert_eq(arr.count_some(), 0uz);
+    arr.set(5, 42);
+    arr.set(99, 7);
+    assert_eq(*arr[5], 42);
+    assert_eq(arr.count_some(), 2uz);
+    arr.reset(5);
+    assert_eq(arr[5].has_value(), false);
+    arr.assign(64, crabi::option<int>{3});
+    assert_eq(arr.count_some(), 2uz);
+}
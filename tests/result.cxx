@@ -0,0 +1,189 @@
+#include <crabi/result.hxx>
+#include <crabi/array.hxx>
+#include <crabi/slice.hxx>
+#include <crabi/str.hxx>
+#include <crabi/non_null.hxx>
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "test.hxx"
+
+struct unit{};
+
+enum class parse_error : std::uint8_t{
+    empty,
+    invalid_digit,
+};
+
+template<typename T> static std::uint8_t byte_at(const T& val, std::size_t i){
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &val, sizeof(T));
+    return bytes[i];
+}
+
+// The expected sizes and bit patterns are those of the equivalent Rust types on x86_64
+
+// Result<u32, u32>, Result<u8, u32>, Result<u64, u8>, Result<u16, u8>
+static_assert(sizeof(crabi::result<std::uint32_t, std::uint32_t>) == 8);
+static_assert(sizeof(crabi::result<std::uint8_t, std::uint32_t>) == 8);
+static_assert(sizeof(crabi::result<std::uint64_t, std::uint8_t>) == 16);
+static_assert(sizeof(crabi::result<std::uint16_t, std::uint8_t>) == 4);
+
+// Result<bool, ()>, Result<(), bool>, Result<&u8, ()>, Result<(), NonNull<u8>>, Result<(), ()>
+static_assert(sizeof(crabi::result<bool, unit>) == 1);
+static_assert(sizeof(crabi::result<unit, bool>) == 1);
+static_assert(sizeof(crabi::result<std::uint8_t&, unit>) == sizeof(void*));
+static_assert(sizeof(crabi::result<unit, crabi::non_null<std::uint8_t>>) == sizeof(void*));
+static_assert(sizeof(crabi::result<unit, unit>) == 1);
+
+// Result<&u8, u64>
+static_assert(sizeof(crabi::result<std::uint8_t&, std::uint64_t>) == 16);
+
+// Result<&[u8], u64>, Result<&[u8], u8>, Result<&str, usize>, Result<u64, &[u8]>: the other variant is stored after the data pointer, which is the niche
+static_assert(sizeof(crabi::result<crabi::slice::slice<const std::uint8_t>, std::uint64_t>) == 16);
+static_assert(sizeof(crabi::result<crabi::slice::slice<const std::uint8_t>, std::uint8_t>) == 16);
+static_assert(sizeof(crabi::result<crabi::str, std::size_t>) == 16);
+static_assert(sizeof(crabi::result<std::uint64_t, crabi::slice::slice<const std::uint8_t>>) == 16);
+
+// Result<&[u8], &[u8]>, Result<&[u8], [u8; 9]>: the other variant does not fit beside the niche
+static_assert(sizeof(crabi::result<crabi::slice::slice<const std::uint8_t>, crabi::slice::slice<const std::uint8_t>>) == 24);
+static_assert(sizeof(crabi::result<crabi::slice::slice<const std::uint8_t>, crabi::array<std::uint8_t, 9>>) == 24);
+
+// Result<Result<u8, u8>, u8>: the error is stored after the tag of the inner result
+static_assert(sizeof(crabi::result<crabi::result<std::uint8_t, std::uint8_t>, std::uint8_t>) == 2);
+
+// Option<Result<u32, u32>>, Option<Result<bool, ()>>
+static_assert(sizeof(crabi::option<crabi::result<std::uint32_t, std::uint32_t>>) == 8);
+static_assert(sizeof(crabi::option<crabi::result<bool, unit>>) == 1);
+
+// Result<[u8; 9], u32>, Option<Result<[u8; 9], u32>>: the larger variant is the less aligned one, so the result is padded beyond it
+static_assert(sizeof(crabi::result<crabi::array<std::uint8_t, 9>, std::uint32_t>) == 12);
+static_assert(sizeof(crabi::option<crabi::result<crabi::array<std::uint8_t, 9>, std::uint32_t>>) == 12);
+
+static_assert(std::is_trivially_copyable_v<crabi::result<std::uint32_t, std::uint32_t>>);
+static_assert(std::is_trivially_copyable_v<crabi::result<int&, crabi::index_error>>);
+static_assert(!std::is_trivially_copyable_v<crabi::result<std::string, int>>);
+
+static crabi::result<int, parse_error> parse(std::string_view s){
+    if(s.empty())
+        return crabi::err(parse_error::empty);
+    int val = 0;
+    for(char c : s){
+        if(c < '0' || c > '9')
+            return crabi::err(parse_error::invalid_digit);
+        val = val * 10 + (c - '0');
+    }
+    return val;
+}
+
+int main(){
+    const int int_values[] = {1, 2, 3};
+    crabi::result<std::uint32_t, std::uint32_t> ok32 = crabi::ok(5u);
+    crabi::result<std::uint32_t, std::uint32_t> err32 = crabi::err(7u);
+    assert_eq(byte_at(ok32, 0), 0);
+    assert_eq(byte_at(ok32, 4), 5);
+    assert_eq(byte_at(err32, 0), 1);
+    assert_eq(byte_at(err32, 4), 7);
+    // The tag of Result<u32, u32> is a u32
+    assert_eq(byte_at(err32, 1) | byte_at(err32, 2) | byte_at(err32, 3), 0);
+
+    crabi::result<std::uint8_t, std::uint32_t> ok8 = crabi::ok(std::uint8_t{5});
+    assert_eq(byte_at(ok8, 1), 5);
+
+    crabi::result<std::uint16_t, std::uint8_t> ok16 = crabi::ok(std::uint16_t{0x102});
+    assert_eq(byte_at(ok16, 2), 2);
+    assert_eq(byte_at(ok16, 3), 1);
+
+    crabi::result<bool, unit> errb = crabi::err(unit{});
+    assert_eq(byte_at(errb, 0), 2);
+    assert_eq(errb.is_err(), true);
+    crabi::result<unit, bool> oku = crabi::ok(unit{});
+    assert_eq(byte_at(oku, 0), 2);
+    assert_eq(oku.is_ok(), true);
+
+    crabi::option<crabi::result<std::uint32_t, std::uint32_t>> none32{};
+    assert_eq(byte_at(none32, 0), 2);
+    crabi::option<crabi::result<bool, unit>> noneb{};
+    assert_eq(byte_at(noneb, 0), 3);
+    crabi::option<crabi::result<bool, unit>> someb{crabi::result<bool, unit>{true}};
+    assert_eq(someb.has_value(), true);
+    assert_eq(**someb, true);
+    crabi::option<crabi::result<crabi::array<std::uint8_t, 9>, std::uint32_t>> none9{};
+    assert_eq(byte_at(none9, 0), 2);
+    crabi::option<crabi::result<crabi::array<std::uint8_t, 9>, std::uint32_t>> some9{crabi::result<crabi::array<std::uint8_t, 9>, std::uint32_t>{crabi::err(std::uint32_t{7})}};
+    assert_eq(some9.has_value(), true);
+    assert_eq(*some9->err(), 7u);
+
+    crabi::slice::slice<const int> ints{int_values};
+    crabi::result<crabi::slice::slice<const int>, std::uint64_t> ok_slice{ints};
+    crabi::result<crabi::slice::slice<const int>, std::uint64_t> err_slice = crabi::err(std::uint64_t{0x1122334455667788});
+    assert_eq(ok_slice.is_ok(), true);
+    assert_eq(ok_slice->size(), 3uz);
+    assert_eq(err_slice.is_err(), true);
+    assert_eq(err_slice.error(), std::uint64_t{0x1122334455667788});
+    for(std::size_t i = 0; i < 8; i++)
+        assert_eq(byte_at(err_slice, i), 0);
+    assert_eq(byte_at(err_slice, 8), 0x88);
+    err_slice = ok_slice;
+    assert_eq(err_slice.is_ok(), true);
+
+    crabi::result<std::uint64_t, crabi::str> ok_str = crabi::ok(std::uint64_t{7});
+    assert_eq(ok_str.is_ok(), true);
+    assert_eq(*ok_str, std::uint64_t{7});
+    assert_eq(byte_at(ok_str, 8), 7);
+    crabi::result<std::uint64_t, crabi::str> err_str = crabi::err(crabi::str{});
+    assert_eq(err_str.is_err(), true);
+
+    crabi::result<crabi::result<std::uint8_t, std::uint8_t>, std::uint8_t> nested = crabi::err(std::uint8_t{9});
+    assert_eq(byte_at(nested, 0), 2);
+    assert_eq(byte_at(nested, 1), 9);
+    assert_eq(nested.error(), 9);
+    nested = crabi::ok(crabi::result<std::uint8_t, std::uint8_t>{crabi::err(std::uint8_t{4})});
+    assert_eq(nested->error(), 4);
+
+    assert_eq(*parse("123"), 123);
+    assert_eq(parse("").error() == parse_error::empty, true);
+    assert_eq(parse("1x").error() == parse_error::invalid_digit, true);
+    assert_eq(parse("12").map([](int v){ return v * 2; }) == crabi::ok(24), true);
+    assert_eq(parse("").map_err([](parse_error){ return -1; }) == crabi::err(-1), true);
+    assert_eq(parse("12").and_then([](int v) -> crabi::result<int, parse_error>{ return v + 1; }).unwrap(), 13);
+    assert_eq(parse("x").or_else([](parse_error) -> crabi::result<int, long>{ return 0; }).unwrap(), 0);
+    assert_eq(parse("x").unwrap_or(-1), -1);
+    assert_eq(parse("x").unwrap_or_else([](parse_error e){ return static_cast<int>(e); }), 1);
+    assert_eq(parse("9").ok().has_value(), true);
+    assert_eq(parse("9").err().has_value(), false);
+
+    bool threw = false;
+    try{
+        (void)parse("").unwrap();
+    }catch(const crabi::bad_result_unwrap&){
+        threw = true;
+    }
+    assert_eq(threw, true);
+
+    crabi::result<std::string, int> s{std::string(64, 'a')};
+    crabi::result<std::string, int> s2 = s;
+    assert_eq(s2->size(), 64uz);
+    s2 = crabi::err(3);
+    assert_eq(s2.error(), 3);
+    s2 = s;
+    assert_eq(*s2 == *s, true);
+    assert_eq(std::move(s).ok()->size(), 64uz);
+
+    crabi::array<int, 4> arr{{1, 2, 3, 4}};
+    assert_eq(*arr.try_get(2), 3);
+    assert_eq(arr.try_get(4).has_value(), false);
+    assert_eq(*arr.checked_at(3), 4);
+    *arr.checked_at(0) = 10;
+    assert_eq(arr[0], 10);
+    assert_eq(arr.checked_at(4).error() == crabi::index_error{4, 4}, true);
+
+    crabi::slice::slice<const int> sl{arr};
+    assert_eq(*sl.try_get(1), 2);
+    assert_eq(*sl.checked_at(1), 2);
+    assert_eq(sl.checked_at(9).error() == crabi::index_error{9, 4}, true);
+}
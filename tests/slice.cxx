@@ -0,0 +1,123 @@
+#include <crabi/slice.hxx>
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+#include "test.hxx"
+
+using crabi::slice::slice;
+
+static_assert(sizeof(slice<int>) == 2 * sizeof(void*));
+static_assert(std::is_trivially_copyable_v<slice<int>>);
+static_assert(sizeof(crabi::option<slice<int>>) == sizeof(slice<int>));
+static_assert(std::ranges::contiguous_range<slice<int>>);
+static_assert(std::ranges::borrowed_range<slice<int>>);
+
+int main(){
+    slice<const int> empty{};
+    assert_eq(empty.size(), 0uz);
+    assert_eq(empty.data() != nullptr, true);
+    assert_eq(crabi::option<slice<const int>>{empty}.has_value(), true);
+    assert_eq(crabi::option<slice<const int>>{}.has_value(), false);
+
+    std::vector<int> empty_vec;
+    slice<int> from_empty{empty_vec};
+    assert_eq(from_empty.data() != nullptr, true);
+
+    std::array<int, 3> std_arr{1, 2, 3};
+    slice<int> from_std_arr{std_arr};
+    assert_eq(from_std_arr.data(), std_arr.data());
+    assert_eq(from_std_arr.size(), 3uz);
+    const std::array<int, 3>& const_std_arr = std_arr;
+    slice<const int> from_const_std_arr{const_std_arr};
+    assert_eq(from_const_std_arr[2], 3);
+    slice deduced{std_arr};
+    static_assert(std::same_as<decltype(deduced), slice<int>>);
+    assert_eq(deduced.size(), 3uz);
+    assert_eq(slice<const int>{std::array<int, 3>{4, 5, 6}}.size(), 3uz);
+
+    int arr[] = {1, 2, 3, 4, 5, 6, 7};
+    slice<int> sl{arr};
+    assert_eq(sl.size(), 7uz);
+    assert_eq(sl[2], 3);
+    assert_eq(*sl.get(6), 7);
+    assert_eq(sl.get(7).has_value(), false);
+    assert_eq(*sl.last(), 7);
+
+    int sum = 0;
+    for(int v : sl)
+        sum += v;
+    assert_eq(sum, 28);
+
+    auto [left, right] = sl.split_at(3);
+    assert_eq(left.size(), 3uz);
+    assert_eq(right.size(), 4uz);
+    assert_eq(right[0], 4);
+
+    bool threw = false;
+    try{
+        (void)sl.split_at(8);
+    }catch(const std::out_of_range&){
+        threw = true;
+    }
+    assert_eq(threw, true);
+
+    std::size_t n_chunks = 0;
+    for(slice<int> c : sl.chunks(3)){
+        assert_eq(c[0], static_cast<int>(n_chunks * 3 + 1));
+        n_chunks++;
+    }
+    assert_eq(n_chunks, 3uz);
+    assert_eq(sl.chunks(3).size(), 3uz);
+    auto whole = sl.subslice(0, 2).chunks(SIZE_MAX);
+    assert_eq(whole.size(), 1uz);
+    assert_eq(std::ranges::distance(whole), 1);
+
+    auto exact = sl.chunks_exact(3);
+    assert_eq(exact.size(), 2uz);
+    assert_eq(std::ranges::distance(exact), 2);
+    assert_eq(exact.remainder().size(), 1uz);
+    assert_eq(exact.remainder()[0], 7);
+
+    auto wins = sl.windows(3);
+    assert_eq(wins.size(), 5uz);
+    std::size_t n_windows = 0;
+    for(slice<int> w : wins){
+        assert_eq(w.size(), 3uz);
+        assert_eq(w[2], static_cast<int>(n_windows + 3));
+        n_windows++;
+    }
+    assert_eq(n_windows, 5uz);
+    assert_eq(sl.windows(8).size(), 0uz);
+    assert_eq(std::ranges::distance(sl.windows(8)), 0);
+
+    std::vector<std::uint8_t> bytes(1000);
+    for(std::size_t i = 0; i < bytes.size(); i++)
+        bytes[i] = static_cast<std::uint8_t>(i % 200);
+    slice<const std::uint8_t> bs{bytes};
+    assert_eq(*bs.position(std::uint8_t{199}), 199uz);
+    assert_eq(bs.contains(std::uint8_t{250}), false);
+    for(std::size_t i = 0; i < 200; i++)
+        assert_eq(*bs.position(static_cast<std::uint8_t>(i)), i);
+
+    std::vector<std::uint64_t> words(333);
+    for(std::size_t i = 0; i < words.size(); i++)
+        words[i] = i * 0x100000001ull;
+    slice<const std::uint64_t> ws{words};
+    assert_eq(*ws.position(std::uint64_t{332 * 0x100000001ull}), 332uz);
+    assert_eq(ws.contains(std::uint64_t{0x100000000ull}), false);
+
+    std::vector<std::uint8_t> copy(1000);
+    slice<std::uint8_t> dst{copy};
+    dst.copy_from_slice(bs);
+    assert_eq(slice<const std::uint8_t>{copy} == bs, true);
+    copy[999] = 1;
+    assert_eq(slice<const std::uint8_t>{copy} == bs, false);
+    assert_eq(bs.starts_with(slice<const std::uint8_t>{copy.data(), 999}), true);
+    assert_eq(bs.starts_with(slice<const std::uint8_t>{copy}), false);
+
+    double ds[] = {0.0, 1.0};
+    double neg[] = {-0.0, 1.0};
+    assert_eq(slice<double>{ds} == slice<double>{neg}, true);
+}
@@ -0,0 +1,145 @@
+#include <crabi/str.hxx>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "test.hxx"
+
+using namespace crabi::literals;
+
+// &str and Option<&str>
+static_assert(sizeof(crabi::str) == 2 * sizeof(void*));
+static_assert(sizeof(crabi::option<crabi::str>) == sizeof(crabi::str));
+static_assert(std::is_trivially_copyable_v<crabi::str>);
+
+static_assert(u8"été"_str.char_count() == 3);
+static_assert(u8"a,b"_str.ends_with(u8",b"_str));
+
+static bool is_valid(std::u8string_view s){
+    return crabi::str::from_utf8(s).is_ok();
+}
+
+// An `error_len` of 0 is an incomplete sequence (`None`)
+static bool error_is(std::u8string_view s, std::size_t valid_up_to, std::uint8_t error_len){
+    auto e = crabi::str::from_utf8(s).err();
+    return e.has_value() && *e == crabi::utf8_error{valid_up_to, error_len ? crabi::option<std::uint8_t>{error_len} : crabi::option<std::uint8_t>{}};
+}
+
+// A string of random characters of every width, into which some bytes are corrupted
+static std::string random_utf8(std::mt19937& rng, std::size_t chars, unsigned corruptions){
+    static constexpr char32_t samples[] = {U'a', U'z', U' ', U'\u00E9', U'\u07FF', U'\u0800', U'\u20AC', U'\uD7FF', U'\uE000', U'\uFFFF', U'\U00010000', U'\U0001F980', U'\U0010FFFF'};
+    std::string out;
+    std::uniform_int_distribution<std::size_t> pick{0, std::size(samples) - 1};
+    std::uniform_int_distribution<int> ascii_run{0, 3};
+    for(std::size_t i = 0; i < chars; i++){
+        char32_t c = ascii_run(rng) ? U'x' : samples[pick(rng)];
+        char8_t buf[4]{};
+        std::size_t len = crabi::_detail::_encode_utf8(c, buf);
+        out.append(reinterpret_cast<const char*>(buf), len);
+    }
+    std::uniform_int_distribution<int> byte{0, 255};
+    for(unsigned k = 0; k < corruptions && !out.empty(); k++)
+        out[std::uniform_int_distribution<std::size_t>{0, out.size() - 1}(rng)] = static_cast<char>(byte(rng));
+    return out;
+}
+
+int main(){
+    // The errors reported by Rust's `core::str::from_utf8` for the same bytes
+    assert_eq(is_valid(u8""), true);
+    assert_eq(is_valid(u8"héllo € \U0001F980"), true);
+    assert_eq(error_is(u8"ab\x80", 2, 1), true);
+    assert_eq(error_is(u8"\xC0\x80", 0, 1), true);
+    assert_eq(error_is(u8"\xC2", 0, 0), true);
+    assert_eq(error_is(u8"a\xE2\x82", 1, 0), true);
+    assert_eq(error_is(u8"\xE2\x82" "a", 0, 2), true);
+    assert_eq(error_is(u8"\xE0\x80\x80", 0, 1), true);
+    assert_eq(error_is(u8"\xED\xA0\x80", 0, 1), true);
+    assert_eq(error_is(u8"\xF0\x8F\xBF\xBF", 0, 1), true);
+    assert_eq(error_is(u8"\xF4\x90\x80\x80", 0, 1), true);
+    assert_eq(error_is(u8"\xF0\x9F\x98" "a", 0, 3), true);
+    assert_eq(error_is(u8"\xF5\x80", 0, 1), true);
+    assert_eq(error_is(u8"\xFF", 0, 1), true);
+
+    crabi::str empty;
+    assert_eq(empty.size(), 0uz);
+    assert_eq(empty.data() != nullptr, true);
+
+    crabi::str s = u8"key=välue=\U0001F980"_str;
+    assert_eq(s.size(), 15uz);
+    assert_eq(s.char_count(), 11uz);
+    assert_eq(s.is_char_boundary(5), true);
+    assert_eq(s.is_char_boundary(6), false);
+    assert_eq(s.floor_char_boundary(6), 5uz);
+    assert_eq(s.ceil_char_boundary(6), 7uz);
+    assert_eq(s.ceil_char_boundary(99), 15uz);
+    assert_eq(s.get(5, 6).has_value(), false);
+    assert_eq(*s.get(4, 7) == u8"vä"_str, true);
+    assert_eq(*s.find(u8"="_str), 3uz);
+    assert_eq(*u8"€\U0001F980"_str.find(U'\U0001F980'), 3uz);
+    assert_eq(*s.find(U'\U0001F980'), 11uz);
+    assert_eq(s.find(u8"x"_str).has_value(), false);
+    assert_eq(*s.find(u8""_str), 0uz);
+    assert_eq(s.contains(U'ä'), true);
+    assert_eq(s.starts_with(u8"key"_str), true);
+    assert_eq(s.ends_with(u8"\U0001F980"_str), true);
+    assert_eq(s < u8"kez"_str, true);
+
+    auto [key, value] = *s.split_once(u8"="_str);
+    assert_eq(key == u8"key"_str, true);
+    assert_eq(value == u8"välue=\U0001F980"_str, true);
+    assert_eq(s.split_once(u8";"_str).has_value(), false);
+
+    auto [left, right] = s.split_at(7);
+    assert_eq(left.as_string_view(), std::string_view{"key=v\xC3\xA4"});
+    assert_eq(right.size(), 8uz);
+    bool threw = false;
+    try{
+        (void)s.split_at(6);
+    }catch(const std::out_of_range&){
+        threw = true;
+    }
+    assert_eq(threw, true);
+
+    std::vector<std::string_view> parts;
+    for(crabi::str part : u8",a,,bé,"_str.split(u8","_str))
+        parts.push_back(part.as_string_view());
+    assert_eq(parts == std::vector<std::string_view>{"", "a", "", "b\xC3\xA9", ""}, true);
+    parts.clear();
+    for(crabi::str part : u8"a::b"_str.split(u8"::"_str))
+        parts.push_back(part.as_string_view());
+    assert_eq(parts == std::vector<std::string_view>{"a", "b"}, true);
+    parts.clear();
+    for(crabi::str part : empty.split(u8"::"_str))
+        parts.push_back(part.as_string_view());
+    assert_eq(parts == std::vector<std::string_view>{""}, true);
+
+    crabi::option<crabi::str> opt{s};
+    assert_eq(opt.has_value(), true);
+    opt = std::nullopt;
+    assert_eq(opt.has_value(), false);
+
+    // The vectorized validator must agree with the scalar one, including at block boundaries
+    std::mt19937 rng{0xC4AB1};
+    for(int iter = 0; iter < 20000; iter++){
+        std::string bytes = random_utf8(rng, static_cast<std::size_t>(iter % 200), iter % 3 == 0 ? 0u : static_cast<unsigned>(iter % 4));
+        auto ptr = reinterpret_cast<const char8_t*>(bytes.data());
+        auto expected = crabi::_detail::_validate_utf8_scalar(ptr, 0, bytes.size());
+        auto actual = crabi::_detail::_validate_utf8(ptr, bytes.size());
+        assert_eq(actual == expected, true);
+        if(actual._m_valid_up_to == bytes.size()){
+            auto str = crabi::str::from_utf8_unchecked(ptr, bytes.size());
+            std::size_t chars = 0;
+            for(char c : bytes)
+                chars += (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+            assert_eq(str.char_count(), chars);
+        }
+    }
+
+    // An incomplete sequence followed by a block of ASCII
+    std::string tail(64, 'a');
+    std::string incomplete = std::string(62, 'a') + "\xE2\x82" + tail;
+    assert_eq(error_is(std::u8string_view{reinterpret_cast<const char8_t*>(incomplete.data()), incomplete.size()}, 62, 2), true);
+}
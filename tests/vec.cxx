@@ -0,0 +1,116 @@
+#include <crabi/vec.hxx>
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "test.hxx"
+
+static_assert(sizeof(crabi::vec<int>) == 3 * sizeof(void*));
+static_assert(sizeof(crabi::boxed_slice<int>) == 2 * sizeof(void*));
+static_assert(sizeof(crabi::option<crabi::vec<int>>) == sizeof(crabi::vec<int>));
+static_assert(sizeof(crabi::option<crabi::boxed_slice<std::string>>) == sizeof(crabi::boxed_slice<std::string>));
+
+/// A stateful allocator that does not propagate on assignment, and checks that each buffer is deallocated by an allocator equal to the one that allocated it
+template<typename T> struct owner_checked_allocator{
+    using value_type = T;
+
+    static inline std::map<void*, int> owners;
+    int id;
+
+    explicit owner_checked_allocator(int id) noexcept : id{id}{}
+    template<typename U> owner_checked_allocator(const owner_checked_allocator<U>& other) noexcept : id{other.id}{}
+
+    T* allocate(std::size_t n){
+        T* p = std::allocator<T>{}.allocate(n);
+        owners[p] = id;
+        return p;
+    }
+
+    void deallocate(T* p, std::size_t n){
+        assert_eq(owners.at(p), id);
+        owners.erase(p);
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    friend bool operator==(const owner_checked_allocator&, const owner_checked_allocator&) = default;
+};
+
+int main(){
+    crabi::vec<int> v;
+    assert_eq(v.data() != nullptr, true);
+    assert_eq(v.capacity(), 0uz);
+    for(int i = 0; i < 1000; i++)
+        v.push_back(i);
+    assert_eq(v.size(), 1000uz);
+    assert_eq(v[999], 999);
+    assert_eq(*v.get(10), 10);
+    assert_eq(v.get(1000).has_value(), false);
+    assert_eq(*v.pop_back(), 999);
+    v.truncate(10);
+    assert_eq(v.size(), 10uz);
+
+    crabi::slice::slice<const int> sl = v;
+    assert_eq(sl.size(), 10uz);
+    assert_eq(*sl.position(7), 7uz);
+
+    crabi::vec<int> copy{sl};
+    assert_eq(copy == v, true);
+    copy.extend_from_slice(sl);
+    assert_eq(copy.size(), 20uz);
+    assert_eq(copy[15], 5);
+
+    auto parts = std::move(copy).into_raw_parts();
+    assert_eq(copy.size(), 0uz);
+    auto adopted = crabi::vec<int>::from_raw_parts(parts.p_data, parts.p_len, parts.p_cap);
+    assert_eq(adopted.size(), 20uz);
+
+    auto boxed = std::move(adopted).into_boxed_slice();
+    assert_eq(boxed.size(), 20uz);
+    assert_eq(boxed[19], 9);
+    auto back = std::move(boxed).into_vec();
+    assert_eq(back.capacity(), 20uz);
+
+    crabi::vec<std::string> strs{"a", "bb", "ccc"};
+    strs.emplace_back(100, 'x');
+    crabi::vec<std::string> strs2 = strs;
+    assert_eq(strs2[3].size(), 100uz);
+    assert_eq(*strs.pop_back(), std::string(100, 'x'));
+    strs.resize(5);
+    assert_eq(strs[4], std::string{});
+
+    crabi::option<crabi::vec<std::string>> ov{std::move(strs2)};
+    assert_eq(ov.has_value(), true);
+    assert_eq(ov->size(), 4uz);
+    ov = std::nullopt;
+    assert_eq(ov.has_value(), false);
+
+    crabi::bump_arena arena;
+    crabi::vec<int, crabi::arena_allocator<int>> av{crabi::arena_allocator<int>{arena}};
+    for(int i = 0; i < 500; i++)
+        av.push_back(i);
+    assert_eq(av[499], 499);
+
+    crabi::size_class_pool pool;
+    crabi::vec<std::string, crabi::pool_allocator<std::string>> pv{crabi::pool_allocator<std::string>{pool}};
+    for(int i = 0; i < 100; i++)
+        pv.emplace_back(std::to_string(i));
+    assert_eq(pv[42], std::string{"42"});
+
+    {
+        using checked_vec = crabi::vec<std::string, owner_checked_allocator<std::string>>;
+        checked_vec a{owner_checked_allocator<std::string>{1}};
+        checked_vec b{owner_checked_allocator<std::string>{2}};
+        a.emplace_back("one");
+        b.emplace_back("two");
+        b = a;
+        assert_eq(b.get_allocator().id, 2);
+        assert_eq(b[0], std::string{"one"});
+        a.emplace_back("three");
+        b = std::move(a);
+        assert_eq(b.get_allocator().id, 2);
+        assert_eq(b.size(), 2uz);
+        assert_eq(b[1], std::string{"three"});
+    }
+    assert_eq(owner_checked_allocator<std::string>::owners.size(), 0uz);
+}